@@ -11,7 +11,9 @@
 #include <sstream>
 #include <functional>
 #include <iomanip>
+#include <filesystem>
 #include "../src/util/json.hpp"
+#include "../src/analyzer/lexical/LexicalAnalyzer.hpp"
 
 std::string pad(std::string s, int l) {
 	l -= s.size();
@@ -90,7 +92,7 @@ long java(const std::string& code) {
  */
 long leekscript(const std::string& code) {
 	std::ostringstream execute;
-	execute << "build/leekscript -n benchmark/code/" << code << "/" << code << ".leek >> results";
+	execute << "build/leekscript -O2 -n benchmark/code/" << code << "/" << code << ".leek >> results";
 	return chronotime([&]() {
 		int r = system(execute.str().c_str());
 		(void) r;
@@ -137,6 +139,10 @@ int main(int argc, char** argv) {
 		Benchmark::operators();
 		return 0;
 	}
+	if (argc > 1 && std::string(argv[1]) == "-l") {
+		Benchmark::lexer();
+		return 0;
+	}
 
 	std::cout << "Starting benchmark..." << std::endl;
 	std::remove("results");
@@ -198,6 +204,28 @@ void Benchmark::operators() {
 	}
 }
 
+/*
+ * Tokenize all the euler test files, many times
+ */
+void Benchmark::lexer() {
+	std::cout << "Starting lexer benchmark..." << std::endl;
+	std::string code;
+	for (const auto& entry : std::filesystem::directory_iterator("test/code/euler")) {
+		code += read_file(entry.path()) + "\n";
+	}
+	size_t tokens = 0;
+	int runs = 100;
+	auto t = chronotime([&]() {
+		for (int i = 0; i < runs; ++i) {
+			ls::File file { "benchmark", code, {}, nullptr };
+			tokens += ls::LexicalAnalyzer().analyze(&file).size();
+		}
+	});
+	std::cout << pad("code size: ", 15) << code.size() << " bytes" << std::endl;
+	std::cout << pad("tokens: ", 15) << tokens / runs << std::endl;
+	std::cout << pad("lexing: ", 15) << (t / runs / 1000) << " µs" << std::endl;
+}
+
 void Benchmark::arrays() {
 
 	auto exe_start = std::chrono::high_resolution_clock::now();
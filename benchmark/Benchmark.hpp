@@ -9,6 +9,7 @@ public:
 	static void arrays();
 	static void primes();
 	static void operators();
+	static void lexer();
 };
 
 #endif
@@ -42,7 +42,15 @@ void CLI::setup_options(CLI11::App& app, CLI_options& options, int argc, char* a
     app.add_flag("-b,--bitcode", options.bitcode, "Output the code bitcode file");
     app.add_flag("-e,--example", options.example, "Get an example snippet");
     app.add_flag("-o,--operations", options.operations, "Enable operations counter and limit");
-    app.add_option("-O", options.optimization, "Optimization level");
+    app.add_flag("--batch_operations", options.batch_operations, "Count the operations in a local counter, check the limit at the loops and calls only");
+    app.add_option("-O", options.optimization, "Optimization level (0 to 3, default 1)");
+    app.add_flag("--optimized_ir", options.optimized_ir, "Output the optimized intermediate representation");
+    app.add_option("--cache", options.cache, "Directory of the compiled code cache");
+    app.add_flag("--lazy", options.lazy, "Compile each function on its first call");
+    app.add_option("--compile_threads", options.compile_threads, "Number of threads compiling the program (default 1)");
+    app.add_option("--profile", options.profile, "Profile the execution and write the folded stacks (flame graph) in a file");
+    app.add_option("--native", options.native, "Compile to a native object (.o) or shared library (.so) instead of executing");
+    app.add_flag("--server", options.server, "Stay alive and execute the scripts sent on stdin (a length line then the code), one JSON result line each");
     app.add_flag("-r,--execute_ir", options.execute_ir, "Execute as an IR file (.ll or .ir)");
     app.add_flag("-c,--execute_bitcode", options.execute_bitcode, "Execute as an bitcode file (.bc)");
 	app.add_flag("--documentation", options.documentation, "Generate and output the documentation as JSON");
@@ -97,6 +105,11 @@ int CLI::start_full(int argc, char* argv[]) {
 		return 0;
 	}
 
+	/** Warm mode : many scripts for one initialization */
+	if (options.server) {
+		return server(options);
+	}
+
 	if (app.remaining().size()) {
 		auto file_or_code = app.remaining().at(0);
 		/** Input file or code snippet? */
@@ -134,6 +147,12 @@ int CLI::analyze_file(std::string file, CLI_options options) {
 int CLI::execute_snippet(std::string code, CLI_options options) {
 	#if COMPILER
 	ls::Environment env { options.legacy };
+	env.optimization = options.optimization;
+	env.cache_directory = options.cache;
+	env.lazy = options.lazy;
+	env.compile_threads = options.compile_threads;
+	env.profile_output = options.profile;
+	env.batch_operations = options.batch_operations;
 	ls::Program program { env, code, "snippet" };
 
 	OutputStringStream oss;
@@ -143,9 +162,14 @@ int CLI::execute_snippet(std::string code, CLI_options options) {
 	if (not options.execute_ir) {
 		env.analyze(program, options.format, options.debug, options.sections);
 	}
-	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+	if (options.native.size()) {
+		env.compile_native(program, options.native);
+		print_result(program.result, "", options.json_output, options.display_time, options.operations);
+		return 0;
+	}
+	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimized_ir, options.execute_ir, options.execute_bitcode);
 	if (not options.execute_ir) {
-		env.execute(program, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+		env.execute(program, options.debug, options.operations, false, options.intermediate, options.optimized_ir, options.execute_ir, options.execute_bitcode);
 	}
 
 	print_result(program.result, oss.str(), options.json_output, options.display_time, options.operations);
@@ -155,9 +179,18 @@ int CLI::execute_snippet(std::string code, CLI_options options) {
 
 int CLI::execute_file(std::string file, CLI_options options) {
 	#if COMPILER
+	if (file.size() > 3 and file.substr(file.size() - 3) == ".so") {
+		return execute_native(file, options);
+	}
 	auto code = ls::Util::read_file(file);
 	auto file_name = Util::file_short_name(file);
 	ls::Environment env { options.legacy };
+	env.optimization = options.optimization;
+	env.cache_directory = options.cache;
+	env.lazy = options.lazy;
+	env.compile_threads = options.compile_threads;
+	env.profile_output = options.profile;
+	env.batch_operations = options.batch_operations;
 	OutputStringStream oss;
 	if (options.json_output)
 		env.output = &oss;
@@ -166,21 +199,46 @@ int CLI::execute_file(std::string file, CLI_options options) {
 	if (not options.execute_ir) {
 		env.analyze(program, options.format, options.debug, options.sections);
 	}
-	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+	if (options.native.size()) {
+		env.compile_native(program, options.native);
+		print_result(program.result, "", options.json_output, options.display_time, options.operations);
+		return 0;
+	}
+	env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimized_ir, options.execute_ir, options.execute_bitcode);
 
-	env.execute(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+	env.execute(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimized_ir, options.execute_ir, options.execute_bitcode);
 
 	print_result(program.result, oss.str(), options.json_output, options.display_time, options.operations);
 	#endif
 	return 0;
 }
 
+int CLI::execute_native(std::string file, CLI_options options) {
+	#if COMPILER
+	ls::Environment env { options.legacy };
+	OutputStringStream oss;
+	if (options.json_output)
+		env.output = &oss;
+	Program program { env, "", file };
+	env.load_native(program);
+	env.execute(program, options.format, options.debug, options.operations);
+	print_result(program.result, oss.str(), options.json_output, options.display_time, options.operations);
+	#endif
+	return 0;
+}
+
 int CLI::repl(CLI_options options) {
 	/** Interactive console mode */
 	#if COMPILER
 	std::cout << "~~~ LeekScript v2.0 ~~~" << std::endl;
 	std::string code;
 	ls::Environment env { options.legacy };
+	env.optimization = options.optimization;
+	env.cache_directory = options.cache;
+	env.lazy = options.lazy;
+	env.compile_threads = options.compile_threads;
+	env.profile_output = options.profile;
+	env.batch_operations = options.batch_operations;
 	ls::Context ctx { env };
 
 	while (!std::cin.eof()) {
@@ -191,7 +249,7 @@ int CLI::repl(CLI_options options) {
 		Program program { env, code, "(top-level)" };
 		program.context = &ctx;
 		env.analyze(program, options.format, options.debug, options.sections);
-		env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimization, options.execute_ir, options.execute_bitcode);
+		env.compile(program, options.format, options.debug, options.operations, false, options.intermediate, options.optimized_ir, options.execute_ir, options.execute_bitcode);
 		env.execute(program, options.debug, options.operations, options.bitcode, options.intermediate);
 		print_result(program.result, "", options.json_output, options.display_time, options.operations);
 		// std::cout << &ctx << std::endl;
@@ -200,33 +258,86 @@ int CLI::repl(CLI_options options) {
 	return 0;
 }
 
+/*
+ * The VM, the environment and its standard library are initialized once, then each script only pays for its own
+ * analysis, compilation and execution. Protocol on stdin : a line with the length in bytes of the code, then the code.
+ * Each script gets one line of JSON on stdout (as with --json), flushed. A wrong length line gets a failure line.
+ */
+int CLI::server(CLI_options options, std::istream& in, std::ostream& out) {
+	#if COMPILER
+	ls::Environment env { options.legacy };
+	env.optimization = options.optimization;
+	env.cache_directory = options.cache;
+	env.lazy = options.lazy;
+	env.compile_threads = options.compile_threads;
+	env.batch_operations = options.batch_operations;
+
+	std::string header;
+	while (std::getline(in, header)) {
+		if (header.empty()) continue;
+		// The length in digits, then optional blanks (\r of a CRLF client)
+		size_t digits = 0, length = 0;
+		while (digits < header.size() and digits < 18 and isdigit((unsigned char) header[digits])) {
+			length = length * 10 + (header[digits++] - '0');
+		}
+		if (digits == 0 or header.find_first_not_of(" \t\r", digits) != std::string::npos) {
+			// A header starting with a length still has its body : skip it to stay in sync
+			if (digits > 0) in.ignore(length);
+			out << "{\"success\":false,\"error\":\"wrong length\"}" << std::endl;
+			continue;
+		}
+		std::string code(length, '\0');
+		in.read(&code[0], length);
+		if ((size_t) in.gcount() != length) break;
+
+		OutputStringStream oss;
+		env.output = &oss;
+		Program program { env, code, "snippet" };
+		env.analyze(program, options.format, options.debug, options.sections);
+		env.compile(program, options.format, options.debug, options.operations);
+		env.execute(program, options.format, options.debug, options.operations);
+		print_json_result(program.result, oss.str(), out);
+		env.output = nullptr;
+	}
+	#endif
+	return 0;
+}
+
 void CLI::print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops) {
 	if (json) {
-		std::ostringstream oss;
-		print_errors(result, oss, json);
-		std::string res = oss.str() + result.value;
-		res = Util::replace_all(res, "\"", "\\\"");
-		res = Util::replace_all(res, "\n", "");
-		std::cout << "{\"success\":true,\"ops\":" << result.operations
-			<< ",\"time\":" << result.execution_time
-			<< ",\"res\":\"" << res << "\""
-			<< ",\"output\":" << Json(output)
-			<< "}" << std::endl;
+		print_json_result(result, output, std::cout);
 	} else {
 		print_errors(result, std::cout, json);
 		if (result.execution_success && result.value != "(void)") {
 			std::cout << result.value << std::endl;
 		}
+		if (result.profile.size()) {
+			std::cout << result.profile;
+		}
 		if (display_time) {
 			std::cout << C_GREY << "(";
 			if (ops) {
 				std::cout << result.operations << " ops, ";
 			}
-			std::cout << result.parse_time << "ms + " << result.compilation_time << "ms + " << result.execution_time << "ms)" << END_COLOR << std::endl;
+			std::cout << result.parse_time << "ms + " << result.compilation_time << "ms" << (result.compilation_cached ? " (cached)" : "") << " + " << result.execution_time << "ms)" << END_COLOR << std::endl;
 		}
 	}
 }
 
+void CLI::print_json_result(ls::Result& result, const std::string& output, std::ostream& os) {
+	std::ostringstream oss;
+	print_errors(result, oss, true);
+	std::string res = oss.str() + result.value;
+	res = Util::replace_all(res, "\"", "\\\"");
+	res = Util::replace_all(res, "\n", "");
+	os << "{\"success\":true,\"ops\":" << result.operations
+		<< ",\"time\":" << result.execution_time
+		<< ",\"cached\":" << (result.compilation_cached ? "true" : "false")
+		<< ",\"res\":\"" << res << "\""
+		<< ",\"output\":" << Json(output)
+		<< "}" << std::endl;
+}
+
 void CLI::print_errors(ls::Result& result, std::ostream& os, bool json) {
 	bool first = true;
 	for (const auto& e : result.errors) {
@@ -39,7 +39,15 @@ struct CLI_options {
 	bool bitcode = false;		// B
 	bool version = false;		// V
 	bool documentation = false;	// --documentation
-	int optimization = 0;		// O
+	int optimization = 1;		// O
+	bool optimized_ir = false;	// --optimized_ir
+	std::string cache = "";		// --cache
+	bool lazy = false;			// --lazy
+	int compile_threads = 1;	// --compile_threads
+	std::string profile = "";	// --profile
+	bool batch_operations = false; // --batch_operations
+	std::string native = "";	// --native
+	bool server = false;		// --server
 	bool intermediate = false;	// I
 	bool example = false;		// E
 	bool execute_ir = false;	// R --execute-ir
@@ -62,10 +70,13 @@ public:
 	int analyze_file(std::string, CLI_options options);
 	int execute_snippet(std::string, CLI_options options);
 	int execute_file(std::string, CLI_options options);
+	int execute_native(std::string, CLI_options options);
 	int repl(CLI_options);
+	int server(CLI_options, std::istream& in = std::cin, std::ostream& out = std::cout);
 
 	void print_errors(ls::Result& result, std::ostream& os, bool json);
 	void print_result(ls::Result& result, const std::string& output, bool json, bool display_time, bool ops);
+	void print_json_result(ls::Result& result, const std::string& output, std::ostream& os);
 };
 
 }
@@ -4,14 +4,31 @@
 #if WASM
 #include <emscripten/emscripten.h>
 
+// The last snippet is kept to be edited incrementally
+static ls::Environment* env = nullptr;
+static ls::Program* program = nullptr;
+static std::string result;
+
+static const char* print_program() {
+	std::ostringstream oss;
+	program->print(oss, true);
+	result = oss.str();
+	return result.c_str();
+}
+
 extern "C" {
 const char* EMSCRIPTEN_KEEPALIVE analyze(char* code) {
-	ls::Environment env;
-	ls::Program program { env, code, "snippet" };
-	env.analyze(program);
-	std::ostringstream oss;
-	program.print(oss, true);
-	return oss.str().c_str();
+	if (not env) env = new ls::Environment();
+	delete program;
+	program = new ls::Program { *env, code, "snippet" };
+	env->analyze(*program);
+	return print_program();
+}
+
+const char* EMSCRIPTEN_KEEPALIVE edit(int start, int end, char* text) {
+	if (not program) return analyze(text);
+	env->edit(*program, start, end, text);
+	return print_program();
 }
 }
 #else
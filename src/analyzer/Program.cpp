@@ -26,7 +26,15 @@
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "../vm/value/LSNumber.hpp"
 #include "../vm/VM.hpp"
+#include "../compiler/CodeCache.hpp"
+#include "../compiler/RefCountElision.hpp"
 #include "llvm/IR/LLVMContext.h"
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/wait.h>
 #endif
 
 namespace ls {
@@ -49,6 +57,9 @@ Program::~Program() {
 	if (handle_created) {
 		compiler->removeModule(module_handle);
 	}
+	if (native_handle) {
+		dlclose(native_handle);
+	}
 	#endif
 }
 
@@ -122,21 +133,41 @@ void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitc
 	c.init();
 	c.vm->context = context;
 
-	module = new llvm::Module(file_name, c.getContext());
-	module->setDataLayout(c.DL);
-
-	main->compile(c);
-
-	if (pseudo_code) {
-		std::error_code EC2;
-		llvm::raw_fd_ostream ir(file_name + ".ll", EC2, llvm::sys::fs::F_None);
-		module->print(ir, nullptr);
-		ir.flush();
+	// Programs with a context depend on the context variables, they are not cached
+	// The exports need the LLVM module, they are not cached either
+	// The lazy and parallel modes produce several objects per program
+	auto cacheable = c.cache.enabled() and not context and not bitcode and not pseudo_code and not optimized_ir and not c.lazy and c.compile_threads <= 1 and not c.profile;
+	auto key = cacheable ? cache_key(c) : "";
+	auto cached_object = c.cache.load(key);
+
+	if (not cached_object) {
+		module = new llvm::Module(file_name, c.getContext());
+		module->setDataLayout(c.DL);
+
+		main->compile(c);
+
+		if (c.optimization_level > 0) {
+			result.refs_elided = RefCountElision::run(*module);
+		}
+
+		if (pseudo_code) {
+			std::error_code EC2;
+			llvm::raw_fd_ostream ir(file_name + ".ll", EC2, llvm::sys::fs::F_None);
+			module->print(ir, nullptr);
+			ir.flush();
+		}
 	}
 
 	auto compilation_start = std::chrono::high_resolution_clock::now();
 
-	module_handle = c.addModule(std::unique_ptr<llvm::Module>(module), true, bitcode, optimized_ir);
+	if (cached_object) {
+		module_handle = c.addObject(std::move(cached_object));
+		result.compilation_cached = true;
+	} else {
+		c.cache.current_key = key;
+		module_handle = c.addModule(std::unique_ptr<llvm::Module>(module), true, bitcode, optimized_ir);
+		c.cache.current_key = "";
+	}
 	handle_created = true;
 	auto ExprSymbol = c.findSymbol("main");
 	assert(ExprSymbol && "Function not found");
@@ -152,6 +183,23 @@ void Program::compile_leekscript(Compiler& c, bool format, bool debug, bool bitc
 	result.compilation_success = true;
 }
 
+/*
+ * Everything that changes the generated object: sources, compiler settings,
+ * target and the LeekScript build itself (runtime structures layouts).
+ */
+std::string Program::cache_key(Compiler& c) const {
+	std::ostringstream oss;
+	oss << "leekscript " << LEEKSCRIPT_VERSION << " " << CodeCache::build_id() << "\n";
+	oss << c.TM->getTargetTriple().str() << " " << c.TM->getTargetCPU().str() << " " << c.TM->getTargetFeatureString().str() << "\n";
+	oss << "legacy " << env.legacy << " O" << c.optimization_level;
+	oss << " ops " << c.vm->enable_operations << " " << c.vm->operation_limit << " " << c.batch_operations << "\n";
+	oss << main_file->path << "\n" << code.size() << "\n" << code;
+	for (const auto& file : main_file->included_files) {
+		oss << "\n" << file->path << "\n" << file->code.size() << "\n" << file->code;
+	}
+	return CodeCache::key(oss.str());
+}
+
 void Program::compile_ir_file(Compiler& c) {
 	llvm::SMDiagnostic Err;
 	auto Mod = llvm::parseIRFile(file_name, Err, c.getContext());
@@ -207,6 +255,120 @@ void Program::compile_bitcode_file(Compiler& c) {
 	result.program = type->to_string() + " " + oss.str();
 }
 
+/*
+ * Link an object into a shared library with the system C++ driver ($CXX, c++ by default), without a shell
+ */
+static bool link_shared(const std::string& object, const std::string& output) {
+	auto driver = getenv("CXX") ? getenv("CXX") : "c++";
+	std::vector<const char*> argv = { driver, "-shared", "-o", output.c_str(), object.c_str(), nullptr };
+	auto pid = fork();
+	if (pid < 0) return false;
+	if (pid == 0) {
+		execvp(driver, (char* const*) argv.data());
+		_exit(127);
+	}
+	int status;
+	if (waitpid(pid, &status, 0) < 0) return false;
+	return WIFEXITED(status) and WEXITSTATUS(status) == 0;
+}
+
+void Program::compile_native(Compiler& c, const std::string& output) {
+
+	if (result.errors.size()) {
+		return;
+	}
+	if (context) {
+		result.compilation_success = false;
+		result.program = "<error>";
+		std::cout << "Native compilation doesn't support contexts" << std::endl;
+		return;
+	}
+	auto compilation_start = std::chrono::high_resolution_clock::now();
+
+	compiler = &c;
+	c.vm->internals.clear();
+	c.program = this;
+	c.init();
+	c.vm->context = nullptr;
+
+	module = new llvm::Module(file_name, c.getContext());
+	module->setDataLayout(c.DL);
+	main->compile(c);
+
+	// The loader needs the return type of main to convert its result
+	type = main->type->return_type()->fold();
+	auto native_type = type->is_void() ? NativeType::VOID
+		: type->is_bool() ? NativeType::BOOLEAN
+		: type->is_integer() ? NativeType::INTEGER
+		: type->is_long() ? NativeType::LONG
+		: type->is_real() ? NativeType::REAL
+		: type->is_mpz() ? NativeType::MPZ
+		: type->is_function_pointer() ? NativeType::FUNCTION
+		: NativeType::ANY;
+	auto i32 = llvm::Type::getInt32Ty(c.getContext());
+	new llvm::GlobalVariable(*module, i32, true, llvm::GlobalValue::ExternalLinkage, llvm::ConstantInt::get(i32, (int) native_type), "leekscript_type");
+
+	c.create_symbol_table(*module);
+
+	auto shared = output.size() > 3 and output.substr(output.size() - 3) == ".so";
+	auto object = shared ? output + ".o" : output;
+	auto success = c.emit_object(std::unique_ptr<llvm::Module>(module), object);
+	module = nullptr;
+
+	// The runtime symbols come from the table, the library only needs the C++ runtime (exceptions)
+	if (success and shared) {
+		success = link_shared(object, output);
+		std::remove(object.c_str());
+	}
+
+	auto compilation_end = std::chrono::high_resolution_clock::now();
+	auto compilation_time = std::chrono::duration_cast<std::chrono::nanoseconds>(compilation_end - compilation_start).count();
+	result.compilation_time = (((double) compilation_time / 1000) / 1000);
+	result.compilation_success = success;
+}
+
+void Program::load_native(VM& vm) {
+	auto fail = [&](const std::string& error) {
+		std::cout << C_RED << "Can't load native program " << file_name << ": " << error << END_COLOR << std::endl;
+		result.compilation_success = false;
+		result.program = "<error>";
+	};
+	// A relative path would be searched in the library directories
+	char path[PATH_MAX];
+	if (!realpath(file_name.c_str(), path)) {
+		return fail("file not found");
+	}
+	native_handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+	if (!native_handle) {
+		return fail(dlerror());
+	}
+	auto symbols = (void**) dlsym(native_handle, "leekscript_symbols");
+	auto names = (const char**) dlsym(native_handle, "leekscript_symbol_names");
+	auto count = (int*) dlsym(native_handle, "leekscript_symbol_count");
+	auto native_type = (int*) dlsym(native_handle, "leekscript_type");
+	closure = dlsym(native_handle, "main");
+	if (!symbols or !names or !count or !native_type or !closure) {
+		return fail("not a LeekScript program");
+	}
+	for (int i = 0; i < *count; ++i) {
+		symbols[i] = vm.resolve_symbol(names[i]);
+		if (!symbols[i]) {
+			return fail(std::string("unknown symbol ") + names[i]);
+		}
+	}
+	switch ((NativeType) *native_type) {
+		case NativeType::VOID: type = env.void_; break;
+		case NativeType::BOOLEAN: type = env.boolean; break;
+		case NativeType::INTEGER: type = env.integer; break;
+		case NativeType::LONG: type = env.long_; break;
+		case NativeType::REAL: type = env.real; break;
+		case NativeType::MPZ: type = env.mpz; break;
+		case NativeType::FUNCTION: type = Type::fun(env.void_, {}); break;
+		default: type = env.any;
+	}
+	result.compilation_success = true;
+}
+
 void Program::compile(Compiler& c, bool format, bool debug, bool export_bitcode, bool pseudo_code, bool optimized_ir, bool ir, bool bitcode) {
 	if (ir) {
 		compile_ir_file(c);
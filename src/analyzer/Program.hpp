@@ -43,6 +43,7 @@ public:
 	bool handle_created = false;
 	llvm::Module* module = nullptr;
 	llvm::orc::VModuleKey module_handle;
+	void* native_handle = nullptr; // Shared library of a native program
 	#endif
 
 	Program(Environment& env, const std::string& code, const std::string& file_name);
@@ -61,6 +62,15 @@ public:
 	void compile_leekscript(Compiler& c, bool format, bool debug, bool assembly, bool pseudo_code, bool optimized_ir);
 	void compile_ir_file(Compiler& c);
 	void compile_bitcode_file(Compiler& c);
+	std::string cache_key(Compiler& c) const;
+
+	/*
+	 * Ahead-of-time compilation to an object file (.o) or a shared library (.so),
+	 * and loading of a native program shared library (the file name of the program).
+	 */
+	enum class NativeType : int { VOID, BOOLEAN, INTEGER, LONG, REAL, MPZ, FUNCTION, ANY };
+	void compile_native(Compiler& c, const std::string& output);
+	void load_native(VM& vm);
 	#endif
 
 	Variable* get_operator(const std::string& name);
@@ -18,6 +18,8 @@ struct Result {
 	std::string value = "";
 	double parse_time = 0;
 	double compilation_time = 0;
+	bool compilation_cached = false; // Object loaded from the code cache
+	int refs_elided = 0; // Reference counting operations removed from the generated code
 	double execution_time = 0;
 	long operations = 0;
 	int objects_created = 0;
@@ -26,6 +28,7 @@ struct Result {
 	int mpz_objects_deleted = 0;
 	std::string assembly;
 	std::string pseudo_code;
+	std::string profile; // Report of the profiler (hottest functions and lines)
 	const Type* type = nullptr;
 	#if COMPILER
 	vm::ExceptionObj exception;
@@ -3,7 +3,7 @@
 
 namespace ls {
 
-bool Error::translation_loaded = false;
+std::once_flag Error::translation_loaded;
 Json Error::translation;
 
 Error::Error(Type type, ErrorLevel level, File* file, size_t line, size_t character) : type(type), level(level), location(file, Position(line, character, 0), Position(line, character + 1, 0)), focus(file, Position(line, character, 0), Position(line, character + 1, 0)) {}
@@ -26,15 +26,14 @@ Json Error::json() const {
 
 std::string Error::build_message(Type type, std::vector<std::string> parameters) {
 
-	if (!translation_loaded) {
+	std::call_once(translation_loaded, []() {
 		try {
 			translation = Json::parse(Util::read_file("src/doc/error_fr.json"));
 		} catch (std::exception&) {} // LCOV_EXCL_LINE
-		translation_loaded = true;
-	}
+	});
 
 	try {
-		std::string m = translation[type_to_string(type)];
+		std::string m = translation.at(type_to_string(type));
 		size_t pos = 0;
 		size_t i = 0;
 		while ((pos = m.find("%", pos + 1)) != std::string::npos) {
@@ -2,6 +2,7 @@
 #define ERROR_HPP
 
 #include <string>
+#include <mutex>
 #include "../lexical/Token.hpp"
 #include "../../util/json.hpp"
 
@@ -51,7 +52,7 @@ public:
 		ARRAY_OUT_OF_BOUNDS,
 	};
 
-	static bool translation_loaded;
+	static std::once_flag translation_loaded;
 	static Json translation;
 	static std::string type_to_string(Type);
 	static std::string build_message(Type, std::vector<std::string> parameters);
@@ -229,13 +229,17 @@ Hover For::hover(SemanticAnalyzer& analyzer, size_t position) const {
 #if COMPILER
 Compiler::value For::compile(Compiler& c) const {
 
+	Compiler::value output_v { c.env };
+	if (stack_output) {
+		output_v = c.new_stack_array(type->element(), {});
+	}
+
 	c.enter_block(init.get()); // { for init ; cond ; inc { body } }<-- this block
 	c.mark_offset(token->location.start.line);
 
 	c.enter_section(init->sections.front().get());
 
-	Compiler::value output_v { c.env };
-	if (type->is_array()) {
+	if (type->is_array() and not stack_output) {
 		output_v = c.new_array(type->element(), {});
 		c.insn_inc_refs(output_v);
 		c.add_temporary_value(output_v); // Why create variable ? in case of `break 2` the output must be deleted
@@ -250,7 +254,7 @@ Compiler::value For::compile(Compiler& c) const {
 		for (const auto& ins : section->instructions) {
 			ins->compile(c);
 			if (dynamic_cast<Return*>(ins)) {
-				auto return_v = c.clone(output_v);
+				auto return_v = stack_output ? output_v : c.clone(output_v);
 				c.leave_block();
 				return return_v;
 			}
@@ -277,6 +281,7 @@ Compiler::value For::compile(Compiler& c) const {
 	c.enter_loop(end_section, nullptr);
 	auto body_v = body->compile(c);
 	c.inc_ops(1);
+	c.check_ops();
 	if (output_v.v && body_v.v) {
 		c.insn_push_array(output_v, body_v);
 	}
@@ -294,7 +299,7 @@ Compiler::value For::compile(Compiler& c) const {
 
 	// End
 	c.enter_section(end_section);
-	auto return_v = c.clone(output_v);
+	auto return_v = stack_output ? output_v : c.clone(output_v);
 
 	c.leave_block(); // leave init block
 
@@ -21,6 +21,7 @@ public:
 	std::unique_ptr<Block> increment;
 	std::unique_ptr<Block> body;
 	std::vector<Mutation> mutations;
+	bool stack_output = false; // [for ...] only read by a loop, built on the stack of the enclosing block
 
 	For(Environment& env);
 
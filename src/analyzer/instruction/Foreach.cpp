@@ -129,6 +129,8 @@ void Foreach::analyze(SemanticAnalyzer* analyzer, const Type* req_type) {
 
 	container->analyze(analyzer);
 	throws = container->throws;
+	// The container is only read by the loop
+	container->will_not_escape(analyzer);
 
 	analyzer->leave_section();
 
@@ -229,6 +231,15 @@ Hover Foreach::hover(SemanticAnalyzer& analyzer, size_t position) const {
 #if COMPILER
 Compiler::value Foreach::compile(Compiler& c) const {
 
+	auto output = type->element();
+
+	// Potential output [for ...]
+	Compiler::value output_v { c.env };
+	output_v.t = c.env.void_;
+	if (stack_output) {
+		output_v = c.new_stack_array(output, {});
+	}
+
 	c.enter_block(wrapper_block.get());
 	c.enter_section(wrapper_block->sections.front().get());
 
@@ -238,19 +249,17 @@ Compiler::value Foreach::compile(Compiler& c) const {
 		if (key_var) key_var->create_entry(c);
 	}
 
-	auto output = type->element();
-
-	// Potential output [for ...]
-	Compiler::value output_v { c.env };
-	output_v.t = c.env.void_;
-	if (not output->is_void()) {
+	if (not output->is_void() and not stack_output) {
 		output_v = c.new_array(output, {});
 		c.insn_inc_refs(output_v);
 		c.add_temporary_value(output_v); // Why create variable? in case of `break 2` the output must be deleted
 	}
 
-	c.insn_inc_refs(container_v);
-	c.add_temporary_value(container_v);
+	// A container built on the stack is destroyed with its block, without refcount
+	if (not c.is_stack_array(container_v)) {
+		c.insn_inc_refs(container_v);
+		c.add_temporary_value(container_v);
+	}
 
 	auto it = c.iterator_begin(container_v);
 
@@ -308,12 +317,13 @@ Compiler::value Foreach::compile(Compiler& c) const {
 	// it++
 	c.enter_section(increment_section.get());
 	c.iterator_increment(container_v.t, it);
+	c.check_ops();
 	c.leave_section();
 
 	c.enter_section(end_section);
 	container->compile_end(c); // Close the container value
 
-	auto return_v = c.clone(output_v); // otherwise it is delete by the leave_block
+	auto return_v = stack_output ? output_v : c.clone(output_v); // otherwise it is delete by the leave_block
 	c.leave_block(); // { for x in ['a' 'b'] { ... }<--- not this block }<--- this block
 
 	return return_v;
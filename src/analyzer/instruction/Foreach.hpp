@@ -58,6 +58,7 @@ public:
 	Variable* key_var = nullptr;
 
 	ForeachMode mode;
+	bool stack_output = false; // [for ...] only read by a loop, built on the stack of the enclosing block
 
 	Foreach(Environment& env);
 
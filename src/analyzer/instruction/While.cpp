@@ -120,6 +120,7 @@ Compiler::value While::compile(Compiler& c) const {
 	// Condition section
 	auto cond = condition->compile(c);
 	c.inc_ops(1);
+	c.check_ops();
 	auto cond_boolean = c.insn_to_bool(cond);
 	condition->sections.back()->condition = cond_boolean;
 	c.insn_delete_temporary(cond);
@@ -2,6 +2,8 @@
 #include <iostream>
 #include "../../util/utf8.h"
 #include <string.h>
+#include <algorithm>
+#include <limits>
 #include "../error/Error.hpp"
 #include "../../util/Util.hpp"
 
@@ -82,13 +84,30 @@ std::unordered_set<std::string> LexicalAnalyzer::ignored_case_legacy = {
 	"true", "false", "null", "not", "and", "or"
 };
 
-LexicalAnalyzer::LexicalAnalyzer() {
-	// Build token cache map
+/*
+ * Keywords and operators, built once. A word is looked up only if its size and its first byte can match one of them.
+ */
+static size_t max_literal_size = 0;
+static bool literal_first_byte[256] = {};
+
+static std::unordered_map<std::string, TokenType> build_token_map() {
+	std::unordered_map<std::string, TokenType> map;
 	for (size_t j = 0; j < type_literals.size(); ++j) {
 		for (const auto& text : type_literals[j]) {
-			token_map.insert({ text, (TokenType) j });
+			map.insert({ text, (TokenType) j });
+			max_literal_size = std::max(max_literal_size, text.size());
+			literal_first_byte[(unsigned char) text[0]] = true;
 		}
 	}
+	return map;
+}
+
+std::unordered_map<std::string, TokenType> LexicalAnalyzer::token_map = build_token_map();
+
+LexicalAnalyzer::LexicalAnalyzer() {}
+
+bool LexicalAnalyzer::has_upper_case(const std::string& word) {
+	return std::any_of(word.begin(), word.end(), [](char c) { return c >= 'A' and c <= 'Z'; });
 }
 
 LetterType LexicalAnalyzer::getLetterType(unsigned char c, unsigned char nc) {
@@ -110,45 +129,174 @@ LetterType LexicalAnalyzer::getLetterType(unsigned char c, unsigned char nc) {
 	return LetterType::OTHER;
 }
 
+static bool may_be_literal(const std::string& word) {
+	return word.size() and word.size() <= max_literal_size and literal_first_byte[(unsigned char) word[0]];
+}
+
 TokenType LexicalAnalyzer::getTokenType(const std::string& word, TokenType by_default) {
 	// TODO legacy only
-	auto word_lower = Util::tolower(word);
-	bool ignore_case = ignored_case_legacy.find(word_lower) != ignored_case_legacy.end();
-	auto i = ignore_case ? token_map.find(word_lower) : token_map.find(word);
+	if (has_upper_case(word)) {
+		auto word_lower = Util::tolower(word);
+		if (ignored_case_legacy.find(word_lower) != ignored_case_legacy.end()) {
+			return getTokenType(word_lower, by_default);
+		}
+	}
+	if (not may_be_literal(word)) return by_default;
+	auto i = token_map.find(word);
 	if (i != token_map.end()) return i->second;
 	return by_default;
 }
 
 bool LexicalAnalyzer::isToken(const std::string& word) {
-	return token_map.find(word) != token_map.end();
+	return may_be_literal(word) and token_map.find(word) != token_map.end();
 }
 
 std::vector<Token> LexicalAnalyzer::analyze(File* file) {
 
 	this->file = file;
 	file->todos.clear();
+	file->restarts.clear();
+	file->lexical_errors.clear();
 	auto tokens = LexicalAnalyzer::parseTokens(file->code + " ");
 
 	tokens.push_back({ TokenType::FINISHED, file, 0, 0, 1, "" });
 
-	for (size_t i = 0; i < tokens.size(); ++i) {
-		if (i + 1 < tokens.size() && tokens[i].content == "is" && tokens[i + 1].content == "not") {
-			tokens[i].type = TokenType::DIFFERENT;
-			tokens[i].content = "is not";
-			tokens.erase(tokens.begin() + i + 1);
+	merge_tokens(tokens, 0, tokens.size());
+
+	return tokens;
+}
+
+/*
+ * Merge the 'is' 'not' pairs into 'is not' tokens, in one pass
+ */
+void LexicalAnalyzer::merge_tokens(std::vector<Token>& tokens, size_t from, size_t to) {
+	to = std::min(to, tokens.size());
+	size_t w = from;
+	for (size_t r = from; r < to; ++r, ++w) {
+		if (r + 1 < tokens.size() && tokens[r].content == "is" && tokens[r + 1].content == "not") {
+			tokens[r].type = TokenType::DIFFERENT;
+			tokens[r].content = "is not";
+			to = std::max(to, r + 2);
+			if (w != r) tokens[w] = std::move(tokens[r]);
+			r++;
+		} else if (w != r) {
+			tokens[w] = std::move(tokens[r]);
 		}
 	}
+	tokens.erase(tokens.begin() + w, tokens.begin() + to);
+}
 
-	return tokens;
+/*
+ * The lexer restarts at a line start of file->restarts before the edit, where its state is empty. It stops at the
+ * first restart line after the edit which was also a restart line before : the next tokens are the same, shifted.
+ */
+void LexicalAnalyzer::edit(File* file, size_t start, size_t end, const std::string& text) {
+
+	this->file = file;
+	auto offset = [&](size_t raw) {
+		return (size_t) u8_offset((char*) file->code.c_str(), raw);
+	};
+	auto lines = [](const std::string& s) {
+		return (long) std::count(s.begin(), s.end(), '\n');
+	};
+	auto removed = file->code.substr(offset(start), offset(end) - offset(start));
+	auto delta = (long) u8_strlen(text.c_str()) - (long) (end - start);
+	auto delta_lines = lines(text) - lines(removed);
+	file->code.replace(offset(start), removed.size(), text);
+
+	// Never tokenized : the next analysis will do it
+	if (not file->tokens_read) return;
+
+	auto& tokens = file->tokens;
+	auto finished = tokens.back();
+	tokens.pop_back();
+	// First token ending after a raw position
+	auto token_after = [&](size_t raw) {
+		return std::lower_bound(tokens.begin(), tokens.end(), raw, [](const Token& token, size_t raw) {
+			return token.location.end.raw < raw;
+		}) - tokens.begin();
+	};
+	// A 'is not' can't be split by a restart
+	auto merged_before = [&](size_t raw) {
+		auto t = token_after(raw);
+		return t > 0 and tokens[t - 1].type == TokenType::DIFFERENT;
+	};
+
+	auto old_restarts = std::move(file->restarts);
+	auto r = std::upper_bound(old_restarts.begin(), old_restarts.end(), start) - old_restarts.begin();
+	while (r > 0 and merged_before(old_restarts[r - 1])) r--;
+	size_t restart = r > 0 ? old_restarts[r - 1] : 0;
+	size_t restart_line = 1 + std::count(file->code.begin(), file->code.begin() + offset(restart), '\n');
+	file->restarts.assign(old_restarts.begin(), old_restarts.begin() + r);
+
+	auto old_todos = std::move(file->todos);
+	file->todos.clear();
+	for (const auto& todo : old_todos) {
+		if (todo.location.start.raw < restart) file->todos.push_back(todo);
+	}
+	// The lexical errors only have a line : keep the ones before the restart line
+	auto old_errors = std::move(file->lexical_errors);
+	file->lexical_errors.clear();
+	for (const auto& error : old_errors) {
+		if (error.location.start.line < restart_line) file->lexical_errors.push_back(error);
+	}
+
+	// Stop at a line start which was a restart before the edit, after the edited text
+	size_t stop = std::numeric_limits<size_t>::max();
+	auto region = parseTokens(file->code.substr(offset(restart)) + " ", { restart_line, 0, restart }, [&](size_t raw) {
+		if ((long) raw - delta < (long) end) return false;
+		auto old_raw = raw - delta;
+		if (not std::binary_search(old_restarts.begin(), old_restarts.end(), old_raw) or merged_before(old_raw)) return false;
+		stop = old_raw;
+		return true;
+	});
+
+	auto first = token_after(restart);
+	auto last = stop == std::numeric_limits<size_t>::max() ? tokens.size() : token_after(stop);
+	auto shift = [&](Position& position) {
+		position.raw += delta;
+		position.line += delta_lines;
+	};
+	for (size_t t = last; t < tokens.size(); ++t) {
+		shift(tokens[t].location.start);
+		shift(tokens[t].location.end);
+	}
+	tokens.erase(tokens.begin() + first, tokens.begin() + last);
+	tokens.insert(tokens.begin() + first, std::make_move_iterator(region.begin()), std::make_move_iterator(region.end()));
+	tokens.push_back(finished);
+	merge_tokens(tokens, first > 0 ? first - 1 : 0, first + region.size() + 1);
+
+	if (stop == std::numeric_limits<size_t>::max()) return;
+	for (auto restart : old_restarts) {
+		if (restart > stop) file->restarts.push_back(restart + delta);
+	}
+	for (auto& todo : old_todos) {
+		if (todo.location.start.raw > stop) {
+			shift(todo.location.start);
+			shift(todo.location.end);
+			file->todos.push_back(todo);
+		}
+	}
+	// Line of the stop in the old code, the errors from it are the same, shifted
+	long stop_line = 1 + std::count(file->code.begin(), file->code.begin() + offset(stop + delta), '\n') - delta_lines;
+	for (auto& error : old_errors) {
+		if ((long) error.location.start.line >= stop_line) {
+			error.location.start.line += delta_lines;
+			error.location.end.line += delta_lines;
+			error.focus.start.line += delta_lines;
+			error.focus.end.line += delta_lines;
+			file->lexical_errors.push_back(error);
+		}
+	}
 }
 
-std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
+std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code, Position start, std::function<bool(size_t)> stop) {
 
 	const char* string_chars = code.c_str();
 	std::vector<Token> tokens;
 
-	size_t line = 1;
-	size_t character = 0;
+	size_t line = start.line;
+	size_t character = start.column;
 	std::string word = "";
 	bool ident = false;
 	bool number = false;
@@ -162,7 +310,7 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 	bool lineComment = false;
 
 	auto l = strlen(string_chars);
-	size_t h = 0, i = 0, j = 0, k = 0;
+	size_t h = 0, i = 0, j = 0, k = start.raw;
 	char c, nc = code[j];
 	u8_inc(string_chars, &j);
 	LetterType type;
@@ -203,16 +351,16 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					ident = false;
 				} else if (number) {
 					if ((bin || hex) && word.size() == 2) {
-						file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 					}
 					tokens.push_back({ TokenType::NUMBER, file, k, line, character, word });
 					number = bin = hex = false;
 				} else if (string1 || string2) {
 					if (escape) {
 						escape = false;
-						file->errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
 					}
-					word += code.substr(h, i - h);
+					word.append(code, h, i - h);
 				} else if (other) {
 					tokens.push_back({ getTokenType(word, TokenType::UNKNOW), file, k, line, character, word });
 					other = false;
@@ -232,18 +380,18 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 						} else if (c == 't') {
 							word += '\t'; // moves the printing position some spaces to the right.
 						} else {
-							file->errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
+							file->lexical_errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
 						}
 					} else {
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					}
 				} else if (number) {
 					if (word == "0" && (c == 'x' || c == 'b')) {
 						hex = c == 'x';
 						bin = c == 'b';
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					} else if (hex && (c <= 'F' || (c >= 'a' && c <= 'f'))) {
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					} else if (c == 'l' or c == 'L') {
 						word += "l";
 						tokens.push_back({ TokenType::NUMBER, file, k + 1, line, character + 1, word });
@@ -260,7 +408,7 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 						word = "";
 						tokens.push_back({ TokenType::STAR, file, k, line, character, code.substr(h, i - h) });
 					} else {
-						file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 						tokens.push_back({ TokenType::NUMBER, file, k, line, character, word });
 						number = bin = hex = false;
 					}
@@ -268,32 +416,32 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					tokens.push_back({ getTokenType(word, TokenType::UNKNOW), file, k, line, character, word });
 					other = false;
 					ident = true;
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 				} else {
 					ident = true;
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 				}
 			} else if (type == LetterType::NUMBER) {
 				if (number) {
 					if (bin && c > '1') {
-						file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 					} else {
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					}
 				} else if (ident || string1 || string2) {
 					if (escape) {
 						escape = false;
-						file->errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
 					}
-					word += code.substr(h, i - h);
+					word.append(code, h, i - h);
 				} else if (other) {
 					tokens.push_back({ getTokenType(word, TokenType::UNKNOW), file, k, line, character, word });
 					other = false;
 					number = true;
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 				} else {
 					number = true;
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 				}
 			} else if (type == LetterType::QUOTE) {
 				if (ident) {
@@ -303,7 +451,7 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					word = "";
 				} else if (number) {
 					if ((bin || hex) && word.size() == 2) {
-						file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 					}
 					tokens.push_back({ TokenType::NUMBER, file, k, line, character, word });
 					number = bin = hex = false;
@@ -311,7 +459,7 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					word = "";
 				} else if (string2 || (string1 && escape)) {
 					escape = false;
-					word += code.substr(h, k - h);
+					word.append(code, h, i - h);
 				} else if (string1) {
 					tokens.push_back({ TokenType::STRING, file, k, line, character, word });
 					string1 = false;
@@ -332,7 +480,7 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					word = "";
 				} else if (number) {
 					if ((bin || hex) && word.size() == 2) {
-						file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 					}
 					tokens.push_back({ TokenType::NUMBER, file, k, line, character, word });
 					number = bin = hex = false;
@@ -343,10 +491,10 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 						escape = false;
 						word += '\\';
 					}
-					word += code.substr(h, i - h);
+					word.append(code, h, i - h);
 				} else if (string2 && escape) {
 					escape = false;
-					word += code.substr(h, i - h);
+					word.append(code, h, i - h);
 				} else if (string2) {
 					tokens.push_back({ TokenType::STRING, file, k, line, character, word });
 					string2 = false;
@@ -364,40 +512,41 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 					tokens.push_back({ getTokenType(word, TokenType::IDENT), file, k, line, character, word });
 					ident = false;
 					other = true;
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 				} else if (number) {
 					if (!hex && !bin && c == '.' && word.find('.') == std::string::npos && getLetterType(nc, 0) == LetterType::NUMBER) {
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					} else {
 						if ((bin || hex) && word.size() == 2) {
-							file->errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
+							file->lexical_errors.push_back({Error::Type::NUMBER_INVALID_REPRESENTATION, ErrorLevel::ERROR, file, line, character});
 						}
 						tokens.push_back({ TokenType::NUMBER, file, k, line, character, word });
 						number = bin = hex = false;
 						other = true;
-						word = code.substr(h, i - h);
+						word.assign(code, h, i - h);
 					}
 				} else if (string1 || string2) {
 					if (escape && c != '\\') {
 						escape = false;
-						file->errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
+						file->lexical_errors.push_back({Error::Type::UNKNOWN_ESCAPE_SEQUENCE, ErrorLevel::ERROR, file, line, character});
 					}
 					if (!escape && c == '\\') {
 						escape = true;
 					} else {
 						escape = false;
-						word += code.substr(h, i - h);
+						word.append(code, h, i - h);
 					}
 				} else if (other) {
-					auto buff = code.substr(h, i - h);
-					if ((c == '!' and word == "!") or not isToken(word + buff)) {
+					auto size = word.size();
+					auto bang = c == '!' and word == "!";
+					word.append(code, h, i - h);
+					if (bang or not isToken(word)) {
+						word.resize(size);
 						tokens.push_back({ getTokenType(word, TokenType::UNKNOW), file, k, line, character, word });
-						word = buff;
-					} else {
-						word += buff;
+						word.assign(code, h, i - h);
 					}
 				} else {
-					word = code.substr(h, i - h);
+					word.assign(code, h, i - h);
 					other = true;
 				}
 			}
@@ -420,10 +569,15 @@ std::vector<Token> LexicalAnalyzer::parseTokens(const std::string& code) {
 		if (c == '\n') {
 			line++;
 			character = 0;
+			// Nothing pending : the lexer can restart here
+			if (comment == 0 and not lineComment and not ident and not number and not string1 and not string2 and not other) {
+				file->restarts.push_back(k);
+				if (stop and stop(k)) return tokens;
+			}
 		}
 	}
 	if (string1 or string2) {
-		file->errors.push_back({Error::Type::UNTERMINATED_STRING, ErrorLevel::ERROR, file, line, character});
+		file->lexical_errors.push_back({Error::Type::UNTERMINATED_STRING, ErrorLevel::ERROR, file, line, character});
 	}
 	return tokens;
 }
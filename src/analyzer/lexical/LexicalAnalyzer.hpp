@@ -5,6 +5,7 @@
 #include <unordered_set>
 #include <vector>
 #include <string>
+#include <functional>
 #include "Token.hpp"
 #include "../resolver/File.hpp"
 
@@ -19,17 +20,32 @@ public:
 
 	static std::unordered_set<std::string> ignored_case_legacy;
 
+	static std::unordered_map<std::string, TokenType> token_map;
+
 	File* file;
-	std::unordered_map<std::string, TokenType> token_map;
 
 	LexicalAnalyzer();
 
+	static bool has_upper_case(const std::string& word);
+
 	LetterType getLetterType(unsigned char c, unsigned char nc);
 	bool isToken(const std::string& word);
 	TokenType getTokenType(const std::string& word, TokenType by_default);
-	std::vector<Token> parseTokens(const std::string& code);
+	/*
+	 * Tokens of a code starting at a position of the file (the beginning by default).
+	 * The lexing ends early when stop() accepts a restart position.
+	 */
+	std::vector<Token> parseTokens(const std::string& code, Position start = { 1, 0, 0 }, std::function<bool(size_t)> stop = nullptr);
 
 	std::vector<Token> analyze(File* file);
+	/*
+	 * Replace the characters [start, end) of the code of a file (raw positions, as in the tokens locations)
+	 * and update its tokens : only the damaged region is re-tokenized, the next tokens are shifted.
+	 */
+	void edit(File* file, size_t start, size_t end, const std::string& text);
+
+private:
+	void merge_tokens(std::vector<Token>& tokens, size_t from, size_t to);
 };
 
 }
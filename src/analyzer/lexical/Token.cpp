@@ -9,10 +9,12 @@ Token::Token(TokenType type, File* file, size_t raw, size_t line, size_t charact
  : type(type), content(content), location(file, {line, character - content.size() - 1, raw - content.size() - 1}, {line, character - 2, raw - 2}) {
 
 	// TODO legacy only
-	auto word_lower = Util::tolower(content);
-	bool ignore_case = LexicalAnalyzer::ignored_case_legacy.find(word_lower) != LexicalAnalyzer::ignored_case_legacy.end();
-	if (ignore_case) {
-		this->content = word_lower;
+	if (LexicalAnalyzer::has_upper_case(content)) {
+		auto word_lower = Util::tolower(content);
+		bool ignore_case = LexicalAnalyzer::ignored_case_legacy.find(word_lower) != LexicalAnalyzer::ignored_case_legacy.end();
+		if (ignore_case) {
+			this->content = word_lower;
+		}
 	}
 
 	if (type == TokenType::STRING) {
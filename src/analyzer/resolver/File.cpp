@@ -1,6 +1,10 @@
 #include "File.hpp"
+#include "../lexical/LexicalAnalyzer.hpp"
 
 namespace ls {
 
+void File::edit(size_t start, size_t end, const std::string& text) {
+	LexicalAnalyzer().edit(this, start, end, text);
+}
 
-}
\ No newline at end of file
+}
@@ -17,6 +17,7 @@ public:
 	std::string code;
 	FileContext context;
 	std::vector<Error> errors;
+	std::vector<Error> lexical_errors; // Errors of the tokens, kept with them until the next edit
 	std::vector<Token> tokens;
 	Token finished_token;
 	std::vector<File*> included_files;
@@ -27,6 +28,7 @@ public:
 	bool tokens_read = false;
 	std::vector<File*> waiters;
 	std::vector<Todo> todos;
+	std::vector<size_t> restarts; // Line starts where the lexer has nothing pending
 	std::unordered_set<File*> entrypoints;
 
 	File(std::string path, std::string code, FileContext context, Program* program) : finished_token({ TokenType::FINISHED, this, 0, 0, 0, "" }) {
@@ -35,6 +37,12 @@ public:
 		this->context = context;
 		this->program = program;
 	}
+
+	/*
+	 * Edit of the code from an editor : replace the characters [start, end) by a text.
+	 * The tokens are updated incrementally, the files including this one parse them at their next analysis.
+	 */
+	void edit(size_t start, size_t end, const std::string& text);
 };
 
 }
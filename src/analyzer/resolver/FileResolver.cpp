@@ -2,26 +2,188 @@
 #include <iostream>
 #include "../../util/Util.hpp"
 #include <unordered_map>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <condition_variable>
 #include "../Program.hpp"
+#include "../lexical/LexicalAnalyzer.hpp"
 
 namespace ls {
 
-// static std::unordered_map<std::string, File*> file_cache;
+/*
+ * The tokenized files by resolved path, shared by the programs of the process. A file is read again when its
+ * modification time or its size changes. Each program gets its own copy of the tokens, the parser edits them.
+ * The least recently used files are evicted past MAX_CACHE_BYTES of source code.
+ */
+struct TokenizedFile {
+	std::filesystem::file_time_type time;
+	uintmax_t size;
+	size_t last_use;
+	std::shared_future<std::shared_ptr<File>> file;
+};
+static const uintmax_t MAX_CACHE_BYTES = 16 << 20;
+static std::unordered_map<std::string, TokenizedFile> file_cache;
+static uintmax_t file_cache_bytes = 0;
+static size_t file_cache_uses = 0;
+static std::mutex file_cache_mutex;
+
+/*
+ * A few threads reading and tokenizing the files, whatever the size of the include graph.
+ * The pending files are dropped at exit, their futures are broken.
+ */
+class TokenizerPool {
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopped = false;
+public:
+	TokenizerPool() {
+		auto count = std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+		for (unsigned i = 0; i < count; ++i) {
+			threads.emplace_back([this]() {
+				while (true) {
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						condition.wait(lock, [this]() { return stopped or not tasks.empty(); });
+						if (stopped) return;
+						task = std::move(tasks.front());
+						tasks.pop_front();
+					}
+					task();
+				}
+			});
+		}
+	}
+	~TokenizerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopped = true;
+		}
+		condition.notify_all();
+		for (auto& thread : threads) thread.join();
+	}
+	template <class F>
+	std::shared_future<std::shared_ptr<File>> add(F f) {
+		auto task = std::make_shared<std::packaged_task<std::shared_ptr<File>()>>(std::move(f));
+		auto future = task->get_future().share();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back([task]() { (*task)(); });
+		}
+		condition.notify_one();
+		return future;
+	}
+};
+
+/*
+ * Started at the first include, and stopped before the cache is destroyed
+ */
+static TokenizerPool& tokenizer_pool() {
+	static TokenizerPool pool;
+	return pool;
+}
+
+static std::shared_future<std::shared_ptr<File>> tokenize(const std::filesystem::path& path);
+
+/*
+ * The paths of the include('...') calls of a file
+ */
+static std::vector<std::filesystem::path> includes(const File& file) {
+	std::vector<std::filesystem::path> paths;
+	const auto& tokens = file.tokens;
+	for (size_t i = 0; i + 3 < tokens.size(); ++i) {
+		if (tokens[i].type == TokenType::IDENT and tokens[i].content == "include" and tokens[i + 1].type == TokenType::OPEN_PARENTHESIS
+			and tokens[i + 2].type == TokenType::STRING and tokens[i + 3].type == TokenType::CLOSING_PARENTHESIS) {
+			paths.push_back((file.context.folder / tokens[i + 2].content).lexically_normal());
+		}
+	}
+	return paths;
+}
+
+/*
+ * Remove the least recently used files until the cache fits, the file being added is not one of them
+ */
+static void evict_files() {
+	while (file_cache_bytes > MAX_CACHE_BYTES and file_cache.size() > 1) {
+		auto oldest = file_cache.begin();
+		for (auto i = file_cache.begin(); i != file_cache.end(); ++i) {
+			if (i->second.last_use < oldest->second.last_use) oldest = i;
+		}
+		file_cache_bytes -= oldest->second.size;
+		file_cache.erase(oldest);
+	}
+}
+
+/*
+ * The file is read and tokenized by the pool, then its includes are started too
+ */
+static std::shared_future<std::shared_ptr<File>> tokenize(const std::filesystem::path& path) {
+	std::error_code error;
+	auto time = std::filesystem::last_write_time(path, error);
+	auto size = error ? 0 : std::filesystem::file_size(path, error);
+	std::lock_guard<std::mutex> lock(file_cache_mutex);
+	auto i = file_cache.find(path);
+	if (i != file_cache.end()) {
+		if (not error and i->second.time == time and i->second.size == size) {
+			i->second.last_use = ++file_cache_uses;
+			return i->second.file;
+		}
+		file_cache_bytes -= i->second.size;
+		file_cache.erase(i);
+	}
+	if (error) return {};
+	auto file = tokenizer_pool().add([path]() {
+		auto file = std::make_shared<File>(path, Util::read_file(path), FileContext(path.parent_path()), nullptr);
+		file->tokens = LexicalAnalyzer().analyze(file.get());
+		file->tokens_read = true;
+		for (const auto& include : includes(*file)) {
+			tokenize(include);
+		}
+		return file;
+	});
+	file_cache[path] = { time, size, ++file_cache_uses, file };
+	file_cache_bytes += size;
+	evict_files();
+	return file;
+}
 
 File* FileResolver::create(std::string path, Program* program) const {
 	auto fspath = std::filesystem::path(path);
-	return /* file_cache[path] = */ new File(path, program->code, FileContext(fspath.parent_path()), program);
+	return new File(path, program->code, FileContext(fspath.parent_path()), program);
 }
 
 File* FileResolver::resolve(std::string path, FileContext context) const {
 	auto resolvedPath = (context.folder / path).lexically_normal();
-	// auto i = file_cache.find(resolvedPath);
-	// if (i != file_cache.end()) {
-	// 	return i->second;
-	// }
-	auto code = Util::read_file(resolvedPath);
 	auto newContext = FileContext(resolvedPath.parent_path());
-	return /* file_cache[path] = */ new File(path, code, newContext, nullptr);
+	auto tokenized = tokenize(resolvedPath);
+	if (not tokenized.valid()) {
+		return new File(path, Util::read_file(resolvedPath), newContext, nullptr);
+	}
+	const auto& source = *tokenized.get();
+	auto file = new File(path, source.code, newContext, nullptr);
+	file->tokens = source.tokens;
+	file->todos = source.todos;
+	file->restarts = source.restarts;
+	file->lexical_errors = source.lexical_errors;
+	for (auto& token : file->tokens) token.location.file = file;
+	for (auto& todo : file->todos) todo.location.file = file;
+	for (auto& error : file->lexical_errors) {
+		error.location.file = file;
+		error.focus.file = file;
+	}
+	file->tokens_read = true;
+	return file;
 }
 
-}
\ No newline at end of file
+void FileResolver::prefetch(File* file) const {
+	for (const auto& include : includes(*file)) {
+		tokenize(include);
+	}
+}
+
+}
@@ -10,8 +10,12 @@ class FileResolver {
 public:
     File* create(std::string path, Program* program) const;
 	File* resolve(std::string path, FileContext context) const;
+	/*
+	 * Read and tokenize in the background the files included by a file, and their own includes
+	 */
+	void prefetch(File* file) const;
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -32,6 +32,11 @@ File* VirtualResolver::resolve(std::string path, FileContext context) const {
 	return nullptr;
 }
 
+/*
+ * The virtual files are already in memory
+ */
+void VirtualResolver::prefetch(File*) const {}
+
 std::unordered_map<std::string, std::unique_ptr<File>>& VirtualResolver::get_cache() {
 	return file_cache;
 }
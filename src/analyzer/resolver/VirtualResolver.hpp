@@ -14,6 +14,7 @@ public:
     File* create(std::string path, Program* program) const;
 	File* delete_(std::string path) const;
 	File* resolve(std::string path, FileContext context) const;
+	void prefetch(File* file) const;
 
     static std::unordered_map<std::string, std::unique_ptr<File>>& get_cache();
 };
@@ -303,6 +303,10 @@ void FunctionVersion::create_function(Compiler& c) {
 	auto f = llvm::Function::Create((llvm::FunctionType*) function_type->llvm(c), llvm::Function::InternalLinkage, fun_name, c.program->module);
 	fun = { f, function_type->pointer() };
 	assert(c.check_value(fun));
+	if (c.profile) {
+		// The profiler walks the stack with the frame pointers
+		f->addFnAttr("frame-pointer", "all");
+	}
 
 	if (body->throws) {
 		auto personalityfn = c.program->module->getFunction("__gxx_personality_v0");
@@ -339,6 +343,7 @@ Compiler::value FunctionVersion::compile(Compiler& c, bool compile_body) {
 		c.enter_function((llvm::Function*) fun.v, parent->captures.size() > 0, this);
 
 		c.enter_section(body->sections.front().get(), false);
+		c.init_ops();
 		// c.builder.SetInsertPoint(block);
 
 		// Declare context vars
@@ -526,7 +531,7 @@ llvm::BasicBlock* FunctionVersion::get_landing_pad(Compiler& c) {
 		// c.insn_call(c.env.void_, {exception}, "System.delete_exception");
 		// c.insn_call(c.env.void_, {}, "__cxa_rethrow");
 		c.insn_call(c.env.void_, {}, "__cxa_end_catch");
-		c.insn_call(c.env.void_, {new_ex, c.new_long((long) &typeid(vm::ExceptionObj)), c.get_symbol("System.delete_exception", c.env.i8_ptr) }, "__cxa_throw");
+		c.insn_call(c.env.void_, {new_ex, c.get_symbol("exception_typeinfo", c.env.i8_ptr), c.get_symbol("System.delete_exception", c.env.i8_ptr) }, "__cxa_throw");
 		// c.insn_call(c.env.void_, {}, "llvm.eh.resume");
 		// c.insn_call(c.env.void_, {}, "_Unwind_Resume");
 		// c.builder.CreateResume(landingPadInst);
@@ -4,6 +4,7 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <atomic>
 #include "../instruction/Instruction.hpp"
 
 namespace ls {
@@ -14,7 +15,7 @@ class Variable;
 
 class Section {
     static const std::vector<std::string> COLORS;
-    static size_t current_id;
+    static std::atomic<size_t> current_id;
 public:
     size_t id;
     Environment& env;
@@ -61,6 +61,10 @@ Block* SyntaxicAnalyzer::analyze(File* file) {
 		file->tokens = lexical.analyze(file);
 		file->tokens_read = true;
 	}
+	// The lexical errors are reported at each analysis, even with cached tokens
+	file->errors.insert(file->errors.end(), file->lexical_errors.begin(), file->lexical_errors.end());
+	// The included files are read and tokenized while this one is parsed
+	resolver->prefetch(file);
 
 	this->t = &file->tokens.at(0);
 	this->nt = file->tokens.size() > 1 ? &file->tokens.at(1) : nullptr;
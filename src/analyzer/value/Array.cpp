@@ -155,6 +155,11 @@ bool Array::elements_will_store(SemanticAnalyzer* analyzer, const Type* type, in
 	return false;
 }
 
+bool Array::will_not_escape(SemanticAnalyzer*) {
+	stack_allocated = expressions.size() > 0;
+	return stack_allocated;
+}
+
 Hover Array::hover(SemanticAnalyzer& analyzer, size_t position) const {
 	for (const auto& expression : expressions) {
 		if (expression->location().contains(position)) {
@@ -171,7 +176,7 @@ Compiler::value Array::compile(Compiler& c) const {
 		auto v = val->compile(c);
 		elements.push_back(v);
 	}
-	auto array = c.new_array(type->element(), elements);
+	auto array = stack_allocated ? c.new_stack_array(type->element(), elements) : c.new_array(type->element(), elements);
 	for (const auto& val : expressions) {
 		val->compile_end(c);
 	}
@@ -25,6 +25,7 @@ public:
 	void elements_will_take(SemanticAnalyzer*, const std::vector<const Type*>&, int level);
 	virtual bool will_store(SemanticAnalyzer* analyzer, const Type* type) override;
 	virtual bool elements_will_store(SemanticAnalyzer* analyzer, const Type* type, int level) override;
+	virtual bool will_not_escape(SemanticAnalyzer* analyzer) override;
 
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
 
@@ -1,4 +1,5 @@
 #include "ArrayFor.hpp"
+#include "../instruction/Foreach.hpp"
 #include "../semantic/SemanticAnalyzer.hpp"
 
 namespace ls {
@@ -40,6 +41,15 @@ void ArrayFor::analyze(SemanticAnalyzer* analyzer) {
 	throws = forr->throws;
 }
 
+bool ArrayFor::will_not_escape(SemanticAnalyzer*) {
+	if (auto foreach = dynamic_cast<Foreach*>(forr.get())) {
+		foreach->stack_output = stack_allocated = true;
+	} else if (auto f = dynamic_cast<For*>(forr.get())) {
+		f->stack_output = stack_allocated = true;
+	}
+	return stack_allocated;
+}
+
 #if COMPILER
 Compiler::value ArrayFor::compile(Compiler& c) const {
 	return forr->compile(c);
@@ -17,6 +17,7 @@ public:
 
 	virtual void pre_analyze(SemanticAnalyzer*) override;
 	virtual void analyze(SemanticAnalyzer*) override;
+	virtual bool will_not_escape(SemanticAnalyzer*) override;
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
 
 	#if COMPILER
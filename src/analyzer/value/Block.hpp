@@ -29,6 +29,7 @@ public:
 	#if COMPILER
 	std::vector<Compiler::value> temporary_values;
 	std::vector<Compiler::value> temporary_expression_values;
+	std::vector<Compiler::value> stack_values; // Containers built on the stack, destroyed at the end of the block, reset by enter_block / leave_block
 	Compiler::value return_value;
 	#endif
 
@@ -237,6 +237,29 @@ Hover Expression::hover(SemanticAnalyzer& analyzer, size_t position) const {
 }
 
 #if COMPILER
+/*
+ * s = s + a + b, with s a local string variable : the operands to append to s.
+ * Appended in place, the string of the variable is reused as a builder instead of being copied by each +.
+ */
+static bool string_append_operands(const Expression* ex, std::vector<const Value*>& operands) {
+	auto vv = dynamic_cast<const VariableValue*>(ex->v1.get());
+	if (!vv or !vv->update_variable or vv->scope != VarScope::LOCAL or !vv->var or !vv->var->parent) return false;
+	// The new version of s takes the entry of the previous one
+	if (vv->var->entry.v or !vv->var->parent->entry.v) return false;
+	if (!vv->var->type->fold()->is_string() or vv->var->type != vv->var->parent->type) return false;
+	const Value* left = ex->v2.get();
+	while (auto plus = dynamic_cast<const Expression*>(left)) {
+		if (!plus->op or plus->op->type != TokenType::PLUS or plus->op->reversed) return false;
+		// Operands converted to string like Value.operator+= does (not the longs, printed differently)
+		auto t = plus->v2->type->fold();
+		if (not (t->is_string() or t->is_integer() or t->is_real() or t->is_bool() or t->is_any())) return false;
+		operands.insert(operands.begin(), plus->v2.get());
+		left = plus->v1.get();
+	}
+	auto first = dynamic_cast<const VariableValue*>(left);
+	return first and first->var == vv->var->parent and operands.size();
+}
+
 Compiler::value Expression::compile(Compiler& c) const {
 
 	// No operator : compile v1 and return
@@ -273,14 +296,41 @@ Compiler::value Expression::compile(Compiler& c) const {
 					c.insn_delete_variable(vv->var->parent->entry);
 				}
 			}
-			auto x_addr = ((LeftValue*) array_access->array.get())->compile_l(c);
+			// The value first : it can add a field to the object holding the array (o.a[] = (o.b = 1)),
+			// which would move the address of the array
 			auto y = c.insn_to_any(v2->compile(c));
+			c.add_temporary_expression_value(y);
+			auto x_addr = ((LeftValue*) array_access->array.get())->compile_l(c);
+			c.pop_temporary_expression_value();
 			auto r = c.insn_invoke(c.env.any, {x_addr, y}, "Value.operator+=");
 			v2->compile_end(c);
 			return r;
 		}
 	}
 
+	// s = s + a + b ==> s += a, s += b
+	std::vector<const Value*> operands;
+	if (op->type == TokenType::EQUAL and string_append_operands(this, operands)) {
+		// Evaluated right to left like the + operators, before modifying s
+		std::vector<Compiler::value> values;
+		for (auto o = operands.rbegin(); o != operands.rend(); ++o) {
+			auto value = c.insn_to_any((*o)->compile(c));
+			(*o)->compile_end(c);
+			c.add_temporary_expression_value(value);
+			values.insert(values.begin(), value);
+		}
+		for (size_t i = 0; i < operands.size(); ++i) {
+			c.pop_temporary_expression_value();
+		}
+		auto x_addr = ((LeftValue*) v1.get())->compile_l(c);
+		for (const auto& value : values) {
+			c.insn_invoke(c.env.any, {x_addr, value}, "Value.operator+=");
+		}
+		v1->compile_end(c);
+		if (is_void) return { c.env };
+		return c.insn_load(x_addr);
+	}
+
 	// x ?? y ==> if (x != null) { x } else { y }
 	if (op->type == TokenType::DOUBLE_QUESTION_MARK) {
 		Compiler::label label_then = c.insn_init_label("then");
@@ -327,8 +377,15 @@ Compiler::value Expression::compile(Compiler& c) const {
 
 	assert(callable_version);
 
+	// o.a <=> o.b : adding the field a can move the address of the field b, take it again once both exist
+	auto field_v2 = callable_version.template_()->v1_addr and callable_version.template_()->v2_addr and dynamic_cast<ObjectAccess*>(v1.get()) ? dynamic_cast<ObjectAccess*>(v2.get()) : nullptr;
+	Compiler::value object_v2 { nullptr, nullptr };
+
 	std::vector<Compiler::value> args;
-	auto compiled_v2 = [&](){ if (callable_version.template_()->v2_addr) {
+	auto compiled_v2 = [&](){ if (field_v2) {
+		object_v2 = field_v2->compile_l_object(c);
+		return field_v2->compile_l_field(c, object_v2);
+	} else if (callable_version.template_()->v2_addr) {
 		return ((LeftValue*) v2.get())->compile_l(c);
 	} else {
 		auto v = v2->compile(c);
@@ -351,6 +408,9 @@ Compiler::value Expression::compile(Compiler& c) const {
 		}
 		return v;
 	}}();
+	if (field_v2) {
+		compiled_v2 = field_v2->compile_l_field(c, object_v2);
+	}
 	args.push_back(compiled_v1);
 	args.push_back(compiled_v2);
 	if (op->reversed) std::reverse(args.begin(), args.end());
@@ -17,6 +17,7 @@
 #include "../resolver/File.hpp"
 #if COMPILER
 #include "../../compiler/Compiler.hpp"
+#include "../../standard/class/ArraySTD.hpp"
 #endif
 
 namespace ls {
@@ -326,6 +327,15 @@ Completion FunctionCall::autocomplete(SemanticAnalyzer& analyzer, size_t positio
 	return { analyzer.env.void_ };
 }
 
+/*
+ * a.map(f), a.filter(f) : the result array is built on the stack (Module::STACK_RESULT).
+ * The other methods ignore the flag and return a heap value.
+ */
+bool FunctionCall::will_not_escape(SemanticAnalyzer*) {
+	stack_allocated = call.object and type->is_array();
+	return stack_allocated;
+}
+
 Hover FunctionCall::hover(SemanticAnalyzer& analyzer, size_t position) const {
 	if (function->location().contains(position)) {
 		auto hover = function->hover(analyzer, position);
@@ -363,6 +373,12 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 		callable_version.compile_mutators(c, { arguments[0].get() });
 	}
 
+	// a.map(f).filter(g).sum() : a single loop
+	Compiler::value fused { c.env };
+	if (compile_pipeline(c, fused)) {
+		return fused;
+	}
+
 	std::vector<LSValueType> types;
 	std::vector<Compiler::value> args;
 	// Pre-compile the call (compile the potential object first)
@@ -370,6 +386,20 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 		args.push_back(call.pre_compile_call(c));
 		types.push_back(args.at(0).t->id());
 	}
+	compile_arguments(c, args, types);
+
+	// Check arguments
+	c.insn_check_args(args, types);
+	int flags = is_void ? Module::NO_RETURN : 0;
+	if (stack_allocated) flags |= Module::STACK_RESULT;
+	auto r = call.compile_call(c, callable_version, args, flags);
+	// std::cout << "FC compiled type " << r.t << std::endl;
+	c.inc_ops(1);
+	compile_arguments_end(c);
+	return r;
+}
+
+void FunctionCall::compile_arguments(Compiler& c, std::vector<Compiler::value>& args, std::vector<LSValueType>& types) const {
 
 	int offset = call.object ? 1 : 0;
 	auto f = callable_version.type->function();
@@ -392,18 +422,61 @@ Compiler::value FunctionCall::compile(Compiler& c) const {
 			args.push_back(((Function*) f)->defaultValues.at(i)->compile(c));
 		}
 	}
-	// Check arguments
-	c.insn_check_args(args, types);
-	int flags = is_void ? Module::NO_RETURN : 0;
-	auto r = call.compile_call(c, callable_version, args, flags);
-	// std::cout << "FC compiled type " << r.t << std::endl;
-	c.inc_ops(1);
+}
+
+void FunctionCall::compile_arguments_end(Compiler& c) const {
 	for (unsigned i = 0; i < callable_version.type->arguments().size(); ++i) {
 		if (i < arguments.size()) {
 			arguments.at(i)->compile_end(c);
 		}
 	}
-	return r;
+}
+
+/*
+ * Chain of array methods ending with this call (ArraySTD::pipeline), compiled as a single loop
+ * over the first container. The lambdas of all the stages are compiled first, then called
+ * element by element. False if there's no chain to fuse.
+ */
+bool FunctionCall::compile_pipeline(Compiler& c, Compiler::value& r) const {
+	if (not call.object or ArraySTD::stage(callable_version) == ArraySTD::Stage::NONE) {
+		return false;
+	}
+	std::vector<const FunctionCall*> calls { this };
+	while (true) {
+		auto inner = dynamic_cast<const FunctionCall*>(calls.front()->call.object);
+		if (not inner or not inner->call.object or inner->include) break;
+		auto stage = ArraySTD::stage(inner->callable_version);
+		if (stage != ArraySTD::Stage::MAP and stage != ArraySTD::Stage::FILTER) break;
+		calls.insert(calls.begin(), inner);
+	}
+	auto source = calls.front()->call.object;
+	if (calls.size() < 2 or not (source->type->is_array() or source->type->is_interval())) {
+		return false;
+	}
+	auto container = calls.front()->call.pre_compile_call(c);
+	std::vector<Compiler::value> checked { container };
+	std::vector<LSValueType> types { container.t->id() };
+	std::vector<ArraySTD::Stage> stages;
+	std::vector<std::vector<Compiler::value>> args;
+	for (const auto& call : calls) {
+		stages.push_back(ArraySTD::stage(call->callable_version));
+		std::vector<Compiler::value> stage_args;
+		std::vector<LSValueType> stage_types;
+		call->compile_arguments(c, stage_args, stage_types);
+		checked.insert(checked.end(), stage_args.begin(), stage_args.end());
+		types.insert(types.end(), stage_types.begin(), stage_types.end());
+		args.push_back(stage_args);
+	}
+	c.insn_check_args(checked, types);
+	int flags = is_void ? Module::NO_RETURN : 0;
+	if (stack_allocated) flags |= Module::STACK_RESULT;
+	r = ArraySTD::pipeline(c, callable_version.type->return_type(), container, stages, args, flags);
+	c.inc_ops(calls.size());
+	for (const auto& call : calls) {
+		call->compile_arguments_end(c);
+	}
+	source->compile_end(c);
+	return true;
 }
 #endif
 
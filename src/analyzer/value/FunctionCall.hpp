@@ -48,11 +48,15 @@ public:
 	void set_version(SemanticAnalyzer*, const std::vector<const Type*>& args, int level) override;
 	virtual const Type* version_type(std::vector<const Type*>) const override;
 	virtual void analyze(SemanticAnalyzer*) override;
+	virtual bool will_not_escape(SemanticAnalyzer*) override;
 	virtual Completion autocomplete(SemanticAnalyzer& analyzer, size_t position) const override;
 	virtual Hover hover(SemanticAnalyzer& analyzer, size_t position) const override;
 
 	#if COMPILER
 	virtual Compiler::value compile(Compiler&) const override;
+	void compile_arguments(Compiler&, std::vector<Compiler::value>& args, std::vector<LSValueType>& types) const;
+	void compile_arguments_end(Compiler&) const;
+	bool compile_pipeline(Compiler&, Compiler::value& r) const;
 	#endif
 
 	virtual std::unique_ptr<Value> clone(Block* parent) const override;
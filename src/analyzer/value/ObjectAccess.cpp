@@ -350,6 +350,13 @@ Compiler::value ObjectAccess::compile(Compiler& c) const {
 
 	// Default : object.attr
 	auto o = object->compile(c);
+	// Object (or maybe one) : load the field with an inline cache of its shape
+	auto object_type = o.t->fold();
+	if (not o.t->temporary and type->fold()->is_any() and (object_type->is_any() or object_type->is_object())) {
+		auto r = c.insn_object_attr(o, field->content, type);
+		object->compile_end(c);
+		return r;
+	}
 	auto k = c.new_const_string(field->content);
 	auto r = c.insn_invoke(type, {c.get_vm(), o, k}, "Value.attr");
 	object->compile_end(c);
@@ -365,12 +372,20 @@ Compiler::value ObjectAccess::compile_version(Compiler& c, std::vector<const Typ
 }
 
 Compiler::value ObjectAccess::compile_l(Compiler& c) const {
+	return compile_l_field(c, compile_l_object(c));
+}
+
+Compiler::value ObjectAccess::compile_l_object(Compiler& c) const {
 	auto o = [&]() { if (object->isLeftValue()) {
 		return c.insn_load(((LeftValue*) object.get())->compile_l(c));
 	} else {
 		return object->compile(c);
 	}}();
 	object->compile_end(c);
+	return o;
+}
+
+Compiler::value ObjectAccess::compile_l_field(Compiler& c, Compiler::value o) const {
 	auto k = c.new_const_string(field->content);
 	return c.insn_invoke(type->pointer(), {o, k}, "Value.attrL");
 }
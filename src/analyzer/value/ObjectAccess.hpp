@@ -53,6 +53,9 @@ public:
 	virtual Compiler::value compile(Compiler&) const override;
 	virtual Compiler::value compile_version(Compiler& c, std::vector<const Type*> version) const override;
 	virtual Compiler::value compile_l(Compiler&) const override;
+	// compile_l in two steps : the object, then the address of the field in the object
+	Compiler::value compile_l_object(Compiler&) const;
+	Compiler::value compile_l_field(Compiler&, Compiler::value object) const;
 	#endif
 
 	virtual std::unique_ptr<Value> clone(Block* parent) const override;
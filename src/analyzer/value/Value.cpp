@@ -41,6 +41,10 @@ bool Value::must_be_any(SemanticAnalyzer* analyzer) {
 	return true;
 }
 
+bool Value::will_not_escape(SemanticAnalyzer*) {
+	return false;
+}
+
 void Value::must_return_any(SemanticAnalyzer*) {}
 
 void Value::set_version(SemanticAnalyzer* analyzer, const std::vector<const Type*>& args, int) {
@@ -39,6 +39,7 @@ public:
 	bool throws = false;
 	bool jumping = false; // Indicates that the value contains a jump
 	bool breaking = false;
+	bool stack_allocated = false; // Doesn't escape its block, built on the stack
 	Section* end_section = nullptr;
 
 	Value() = delete;
@@ -62,6 +63,7 @@ public:
 	virtual bool will_store(SemanticAnalyzer*, const Type*);
 	virtual bool elements_will_store(SemanticAnalyzer*, const Type*, int level);
 	virtual bool must_be_any(SemanticAnalyzer*);
+	virtual bool will_not_escape(SemanticAnalyzer*);
 	virtual void must_return_any(SemanticAnalyzer*);
 	virtual void set_version(SemanticAnalyzer*, const std::vector<const Type*>&, int level);
 	virtual const Type* version_type(std::vector<const Type*>) const;
@@ -0,0 +1,66 @@
+#include "CodeCache.hpp"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Set by the Makefile to a hash of the sources
+#ifndef LEEKSCRIPT_BUILD_ID
+	#define LEEKSCRIPT_BUILD_ID __DATE__ " " __TIME__
+#endif
+
+namespace ls {
+
+std::string CodeCache::key(const std::string& data) {
+	llvm::SHA1 sha;
+	sha.update(data);
+	return llvm::toHex(sha.result(), true);
+}
+
+std::string CodeCache::build_id() {
+	return LEEKSCRIPT_BUILD_ID;
+}
+
+std::string CodeCache::path(const std::string& key) const {
+	llvm::SmallString<128> path { directory };
+	llvm::sys::path::append(path, key + ".o");
+	return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> CodeCache::load(const std::string& key) const {
+	if (not enabled() or key.empty()) return nullptr;
+	auto buffer = llvm::MemoryBuffer::getFile(path(key), -1, false);
+	if (!buffer) return nullptr;
+	return std::move(buffer.get());
+}
+
+void CodeCache::notifyObjectCompiled(const llvm::Module*, llvm::MemoryBufferRef Obj) {
+	if (not enabled() or current_key.empty()) return;
+	if (llvm::sys::fs::create_directories(directory)) return;
+	// Write in a unique temporary file then rename it : other processes, or environments running on other threads,
+	// may write or read the same object at the same time
+	auto file = path(current_key);
+	int fd;
+	llvm::SmallString<128> tmp_file;
+	if (llvm::sys::fs::createUniqueFile(file + ".%%%%%%%%.tmp", fd, tmp_file)) return;
+	{
+		llvm::raw_fd_ostream out(fd, true);
+		out << Obj.getBuffer();
+		out.flush();
+		if (out.has_error()) {
+			out.clear_error();
+			llvm::sys::fs::remove(tmp_file);
+			return;
+		}
+	}
+	if (llvm::sys::fs::rename(tmp_file, file)) {
+		llvm::sys::fs::remove(tmp_file);
+	}
+}
+
+std::unique_ptr<llvm::MemoryBuffer> CodeCache::getObject(const llvm::Module*) {
+	return load(current_key);
+}
+
+}
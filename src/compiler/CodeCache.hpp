@@ -0,0 +1,41 @@
+#ifndef CODE_CACHE_HPP
+#define CODE_CACHE_HPP
+
+#include <string>
+#include <memory>
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace ls {
+
+/*
+ * On-disk cache of the relocatable objects produced by the JIT.
+ * Objects are stored in `directory` under a content hash (the key) of
+ * everything that can change the generated code.
+ */
+class CodeCache : public llvm::ObjectCache {
+public:
+	std::string directory; // Empty: cache disabled
+	std::string current_key; // Key of the module being compiled
+
+	bool enabled() const { return directory.size() > 0; }
+
+	/** Hash some content into a cache key **/
+	static std::string key(const std::string& data);
+
+	/** Identifies the sources of this build : the objects of another build are never reused **/
+	static std::string build_id();
+
+	/** Load a cached object, nullptr on a miss **/
+	std::unique_ptr<llvm::MemoryBuffer> load(const std::string& key) const;
+
+	void notifyObjectCompiled(const llvm::Module* M, llvm::MemoryBufferRef Obj) override;
+	std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* M) override;
+
+private:
+	std::string path(const std::string& key) const;
+};
+
+}
+
+#endif
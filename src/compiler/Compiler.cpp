@@ -9,6 +9,7 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <unistd.h>
 #include "Compiler.hpp"
 #include "../analyzer/value/Function.hpp"
 #include "../vm/value/LSNull.hpp"
@@ -23,6 +24,9 @@
 #include "../type/Type.hpp"
 #include "../analyzer/Program.hpp"
 #include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
+#include "llvm/Support/Format.h"
 #include "../analyzer/resolver/File.hpp"
 #include "../analyzer/semantic/FunctionVersion.hpp"
 #include "../type/Function_type.hpp"
@@ -38,41 +42,21 @@ Compiler::value::value(Environment& env) : v(nullptr), t(env.void_) {}
 Compiler::Compiler(Environment& env, VM* vm) : env(env), Ctx(llvm::make_unique<llvm::LLVMContext>()), builder(*Ctx.getContext()), vm(vm),
 	TM(llvm::EngineBuilder().selectTarget()),
 	DL(TM->createDataLayout()),
-	ObjectLayer(ES, [this](llvm::orc::VModuleKey) {
+	ObjectLayer(ES, [this](llvm::orc::VModuleKey K) {
+		// The partitions of the lazy modules have their own resolver (stubs first), set by the compile-on-demand layer
+		auto r = resolvers.find(K);
 		return llvm::orc::LegacyRTDyldObjectLinkingLayer::Resources {
 			std::make_shared<llvm::SectionMemoryManager>(),
-			createLegacyLookupResolver(ES, [this](const std::string& Name) -> llvm::JITSymbol {
-				// std::cout << "Resolve symbol " << Name << std::endl;
-				if (auto Sym = CompileLayer.findSymbol(Name, false)) {
-					return Sym;
-				} else if (auto Err = Sym.takeError()) {
-					return std::move(Err);
-				}
-				auto s = this->vm->resolve_symbol(Name);
-				if (s) {
-					return llvm::JITSymbol((llvm::JITTargetAddress) s, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				}
-				if (Name == "vm") return llvm::JITSymbol((llvm::JITTargetAddress) this->vm, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "null") return llvm::JITSymbol((llvm::JITTargetAddress) LSNull::get(), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "true") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(true), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "false") return llvm::JITSymbol((llvm::JITTargetAddress) LSBoolean::get(false), llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "mpzc") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_created, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "mpzd") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->mpz_deleted, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-				if (Name == "operations") return llvm::JITSymbol((llvm::JITTargetAddress) &this->vm->operations, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
-
-				if (auto SymAddr = llvm::RTDyldMemoryManager::getSymbolAddressInProcess(Name)) {
-					return llvm::JITSymbol(SymAddr, llvm::JITSymbolFlags::Exported);
-				}
-				return nullptr;
-			},
-			[](llvm::Error Err) {
-				llvm::cantFail(std::move(Err), "lookupFlags failed");
-			})
+			r != resolvers.end() ? r->second : resolver
 		};
+	}, [this](llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info) {
+		object_loaded(K, object, info);
+	}, [](llvm::orc::VModuleKey) {}, [this](llvm::orc::VModuleKey K, const llvm::object::ObjectFile&) {
+		object_freed(K);
 	}),
-	CompileLayer(ObjectLayer, llvm::orc::SimpleCompiler(*TM)),
+	CompileLayer(ObjectLayer, llvm::orc::SimpleCompiler(*TM, &cache)),
 	OptimizeLayer(CompileLayer, [this](std::unique_ptr<llvm::Module> M) {
-		auto m = optimizeModule(std::move(M));
+		auto m = this->optimize ? optimizeModule(std::move(M)) : std::move(M);
 		if (this->export_bitcode) {
 			std::error_code EC;
 			llvm::raw_fd_ostream bitcode(m->getName().str() + ".bc", EC, llvm::sys::fs::F_None);
@@ -86,34 +70,319 @@ Compiler::Compiler(Environment& env, VM* vm) : env(env), Ctx(llvm::make_unique<l
 			ir.flush();
 		}
 		return m;
-	}) {
+	}),
+	resolver(createLegacyLookupResolver(ES, [this](const std::string& Name) -> llvm::JITSymbol {
+		// std::cout << "Resolve symbol " << Name << std::endl;
+		// Runtime symbols first (a table lookup), without searching all the compiled modules
+		auto s = this->vm->resolve_symbol(Name);
+		if (s) {
+			return llvm::JITSymbol((llvm::JITTargetAddress) s, llvm::JITSymbolFlags(llvm::JITSymbolFlags::FlagNames::None));
+		}
+		if (auto Sym = CompileLayer.findSymbol(Name, false)) {
+			return Sym;
+		} else if (auto Err = Sym.takeError()) {
+			return std::move(Err);
+		}
+		if (auto SymAddr = llvm::RTDyldMemoryManager::getSymbolAddressInProcess(Name)) {
+			return llvm::JITSymbol(SymAddr, llvm::JITSymbolFlags::Exported);
+		}
+		return nullptr;
+	},
+	[](llvm::Error Err) {
+		llvm::cantFail(std::move(Err), "lookupFlags failed");
+	})),
+	CompileCallbackManager(cantFail(llvm::orc::createLocalCompileCallbackManager(TM->getTargetTriple(), ES, 0))),
+	// One partition per function : each function version is compiled on its first call
+	CODLayer(ES, OptimizeLayer,
+		[this](llvm::orc::VModuleKey K) {
+			auto r = resolvers.find(K);
+			return r != resolvers.end() ? r->second : resolver;
+		},
+		[this](llvm::orc::VModuleKey K, std::shared_ptr<llvm::orc::SymbolResolver> R) {
+			resolvers[K] = std::move(R);
+		},
+		[](llvm::Function& F) { return std::set<llvm::Function*>({ &F }); },
+		*CompileCallbackManager,
+		llvm::orc::createLocalIndirectStubsManagerBuilder(TM->getTargetTriple())) {
 		llvm::sys::DynamicLibrary::LoadLibraryPermanently(nullptr);
+		set_optimization_level(optimization_level);
 	}
 
+void Compiler::set_optimization_level(int level) {
+	optimization_level = std::max(0, std::min(3, level));
+	// The code generator follows the IR level (SimpleCompiler uses the TargetMachine settings)
+	switch (optimization_level) {
+		case 0: TM->setOptLevel(llvm::CodeGenOpt::None); break;
+		case 1: TM->setOptLevel(llvm::CodeGenOpt::Less); break;
+		case 2: TM->setOptLevel(llvm::CodeGenOpt::Default); break;
+		default: TM->setOptLevel(llvm::CodeGenOpt::Aggressive); break;
+	}
+}
+
+/*
+ * -O0 : no IR optimization at all, fastest compilation
+ * -O1 : function simplification pipeline, always-inline only
+ * -O2 : full module pipeline : inliner, IPO, loop passes (LICM, unroll), loop vectorizer and SLP
+ * -O3 : same as -O2 with a more aggressive inlining threshold and loop transformations
+ */
 std::unique_ptr<llvm::Module> Compiler::optimizeModule(std::unique_ptr<llvm::Module> M) {
-	// Create a function pass manager.
-	auto FPM = llvm::make_unique<llvm::legacy::FunctionPassManager>(M.get());
-	// Add some optimizations.
-	FPM->add(llvm::createBasicAAWrapperPass());
-	FPM->add(llvm::createInstructionCombiningPass());
-	FPM->add(llvm::createReassociatePass());
-	FPM->add(llvm::createGVNPass());
-	FPM->add(llvm::createCFGSimplificationPass());
-	FPM->doInitialization();
-	// Run the optimizations over all functions in the module being added to the JIT.
-	for (auto &F : *M)
-		FPM->run(F);
+	return optimizeModule(std::move(M), *TM);
+}
+
+std::unique_ptr<llvm::Module> Compiler::optimizeModule(std::unique_ptr<llvm::Module> M, llvm::TargetMachine& tm) {
+	if (optimization_level == 0) {
+		return M;
+	}
+	// Target information is needed by the cost models of the vectorizers and the inliner
+	M->setTargetTriple(tm.getTargetTriple().str());
+
+	llvm::PassManagerBuilder PMB;
+	PMB.OptLevel = optimization_level;
+	PMB.SizeLevel = 0;
+	if (optimization_level > 1) {
+		PMB.Inliner = llvm::createFunctionInliningPass(optimization_level, 0, false);
+	} else {
+		PMB.Inliner = llvm::createAlwaysInlinerLegacyPass();
+	}
+	PMB.LoopVectorize = optimization_level > 1;
+	PMB.SLPVectorize = optimization_level > 1;
+	tm.adjustPassManager(PMB);
+
+	llvm::legacy::FunctionPassManager FPM(M.get());
+	FPM.add(llvm::createTargetTransformInfoWrapperPass(tm.getTargetIRAnalysis()));
+	PMB.populateFunctionPassManager(FPM);
+
+	llvm::legacy::PassManager MPM;
+	MPM.add(llvm::createTargetTransformInfoWrapperPass(tm.getTargetIRAnalysis()));
+	PMB.populateModulePassManager(MPM);
+
+	// Per-function simplification first, then the module pipeline (inlining across the function versions, loops, vectorization)
+	FPM.doInitialization();
+	for (auto& F : *M) {
+		FPM.run(F);
+	}
+	FPM.doFinalization();
+	MPM.run(*M);
 	return M;
 }
 
 llvm::orc::VModuleKey Compiler::addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode, bool export_optimized_ir) {
 	auto K = ES.allocateVModule();
+	this->optimize = optimize;
 	this->export_bitcode = export_bitcode;
 	this->export_optimized_ir = export_optimized_ir;
-	cantFail(OptimizeLayer.addModule(K, std::move(M)));
+	// The exports need the whole module at once
+	if (compile_threads > 1 and not lazy and not export_bitcode and not export_optimized_ir) {
+		return addModuleParallel(std::move(M), optimize);
+	}
+	if (lazy and not export_bitcode and not export_optimized_ir) {
+		lazy_modules.insert(K);
+		cantFail(CODLayer.addModule(K, std::move(M)));
+	} else {
+		cantFail(OptimizeLayer.addModule(K, std::move(M)));
+	}
+	return K;
+}
+
+/*
+ * Split the module in compile_threads parts (the local symbols are externalized), and optimize and
+ * generate the object of each part on a thread pool. A LLVMContext can't be used by several threads,
+ * so each part goes through bitcode to its own context and target machine.
+ * The objects are linked together by the object layer, under the key of the first one.
+ */
+llvm::orc::VModuleKey Compiler::addModuleParallel(std::unique_ptr<llvm::Module> M, bool optimize) {
+	std::vector<llvm::SmallVector<char, 0>> parts;
+	llvm::SplitModule(std::move(M), compile_threads, [&](std::unique_ptr<llvm::Module> part) {
+		parts.emplace_back();
+		llvm::raw_svector_ostream os(parts.back());
+		llvm::WriteBitcodeToFile(*part, os);
+	});
+
+	std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects(parts.size());
+	auto level = TM->getOptLevel();
+	{
+		llvm::ThreadPool pool(compile_threads);
+		for (size_t i = 0; i < parts.size(); ++i) {
+			pool.async([&, i]() {
+				llvm::LLVMContext context;
+				auto part = cantFail(llvm::parseBitcodeFile(llvm::MemoryBufferRef(llvm::StringRef(parts[i].data(), parts[i].size()), "part"), context));
+				std::unique_ptr<llvm::TargetMachine> tm { llvm::EngineBuilder().selectTarget() };
+				tm->setOptLevel(level);
+				if (optimize) {
+					part = optimizeModule(std::move(part), *tm);
+				}
+				llvm::SmallVector<char, 0> object;
+				llvm::raw_svector_ostream os(object);
+				llvm::legacy::PassManager PM;
+				tm->addPassesToEmitFile(PM, os, nullptr, llvm::TargetMachine::CGFT_ObjectFile);
+				PM.run(*part);
+				objects[i] = llvm::make_unique<llvm::SmallVectorMemoryBuffer>(std::move(object));
+			});
+		}
+		pool.wait();
+	}
+
+	auto K = ES.allocateVModule();
+	auto& keys = parallel_modules[K];
+	for (auto& object : objects) {
+		auto k = keys.empty() ? K : ES.allocateVModule();
+		cantFail(ObjectLayer.addObject(k, std::move(object)));
+		keys.push_back(k);
+	}
+	return K;
+}
+
+llvm::orc::VModuleKey Compiler::addObject(std::unique_ptr<llvm::MemoryBuffer> O) {
+	auto K = ES.allocateVModule();
+	cantFail(ObjectLayer.addObject(K, std::move(O)));
 	return K;
 }
 
+/*
+ * With the profiler, the functions of each loaded object are registered in the profiler,
+ * in the perf map (/tmp/perf-<pid>.map, read by `perf report`) and in the GDB JIT interface.
+ */
+void Compiler::object_loaded(llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info) {
+	if (not profile) return;
+	llvm::JITEventListener::createGDBRegistrationListener()->notifyObjectLoaded(K, object, info);
+
+	// The debug object has the load addresses of the sections
+	auto debug_object = info.getObjectForDebug(object);
+	const auto& loaded = debug_object.getBinary() ? *debug_object.getBinary() : object;
+	std::error_code EC;
+	llvm::raw_fd_ostream perf_map("/tmp/perf-" + std::to_string(getpid()) + ".map", EC, llvm::sys::fs::F_Append);
+	uint64_t low = UINT64_MAX, high = 0;
+	for (const auto& symbol_size : llvm::object::computeSymbolSizes(loaded)) {
+		const auto& symbol = symbol_size.first;
+		auto type = symbol.getType();
+		auto name = symbol.getName();
+		auto address = symbol.getAddress();
+		if (!type or *type != llvm::object::SymbolRef::ST_Function or !name or !address) {
+			llvm::consumeError(type.takeError());
+			llvm::consumeError(name.takeError());
+			llvm::consumeError(address.takeError());
+			continue;
+		}
+		vm->profiler.add_function(name->str(), *address, symbol_size.second);
+		low = std::min(low, *address);
+		high = std::max(high, *address + symbol_size.second);
+		if (not EC) {
+			perf_map << llvm::format_hex_no_prefix(*address, 1) << " " << llvm::format_hex_no_prefix(symbol_size.second, 1) << " " << *name << "\n";
+		}
+	}
+	profiled_objects[K] = { low, high };
+}
+
+void Compiler::object_freed(llvm::orc::VModuleKey K) {
+	auto o = profiled_objects.find(K);
+	if (o == profiled_objects.end()) return;
+	llvm::JITEventListener::createGDBRegistrationListener()->notifyFreeingObject(K);
+	vm->profiler.remove_functions(o->second.first, o->second.second);
+	profiled_objects.erase(o);
+}
+
+/*
+ * Where to load a value for a use : before the instruction, or at the end of the incoming block for a phi
+ */
+static llvm::Instruction* insertion_point(llvm::Use& use) {
+	assert(llvm::isa<llvm::Instruction>(use.getUser()) && "Runtime symbol used in a global initializer");
+	auto instruction = llvm::cast<llvm::Instruction>(use.getUser());
+	if (auto phi = llvm::dyn_cast<llvm::PHINode>(instruction)) {
+		return phi->getIncomingBlock(use)->getTerminator();
+	}
+	return instruction;
+}
+
+/*
+ * Replace a constant expression by instructions (the nested expressions first)
+ */
+static void expand_constant_expression(llvm::ConstantExpr* expr) {
+	while (not expr->use_empty()) {
+		auto& use = *expr->use_begin();
+		if (auto user = llvm::dyn_cast<llvm::ConstantExpr>(use.getUser())) {
+			expand_constant_expression(user);
+		} else {
+			auto instruction = expr->getAsInstruction();
+			instruction->insertBefore(insertion_point(use));
+			use.set(instruction);
+		}
+	}
+	expr->destroyConstant();
+}
+
+/*
+ * The native objects are not linked by the JIT : every runtime symbol (standard library functions, null, vm, ...)
+ * is replaced by a load from the `leekscript_symbols` table, filled with VM::resolve_symbol when the object is loaded.
+ * The names of the symbols are in `leekscript_symbol_names` (`leekscript_symbol_count` entries).
+ */
+void Compiler::create_symbol_table(llvm::Module& M) {
+	std::vector<llvm::GlobalValue*> symbols;
+	for (auto& F : M) {
+		if (F.isDeclaration() and not F.isIntrinsic() and vm->resolve_symbol(F.getName().str())) {
+			symbols.push_back(&F);
+		}
+	}
+	for (auto& G : M.globals()) {
+		if (G.isDeclaration() and vm->resolve_symbol(G.getName().str())) {
+			symbols.push_back(&G);
+		}
+	}
+	auto& context = M.getContext();
+	auto i8_ptr = llvm::Type::getInt8PtrTy(context);
+	auto i32 = llvm::Type::getInt32Ty(context);
+	auto table_type = llvm::ArrayType::get(i8_ptr, symbols.size());
+	auto table = new llvm::GlobalVariable(M, table_type, false, llvm::GlobalValue::ExternalLinkage, llvm::ConstantAggregateZero::get(table_type), "leekscript_symbols");
+
+	std::vector<llvm::Constant*> names;
+	for (size_t i = 0; i < symbols.size(); ++i) {
+		auto symbol = symbols[i];
+		auto name_data = llvm::ConstantDataArray::getString(context, symbol->getName());
+		auto name = new llvm::GlobalVariable(M, name_data->getType(), true, llvm::GlobalValue::PrivateLinkage, name_data, "symbol_name");
+		names.push_back(llvm::ConstantExpr::getPointerCast(name, i8_ptr));
+
+		auto slot = llvm::ConstantExpr::getInBoundsGetElementPtr(table_type, table, llvm::ArrayRef<llvm::Constant*> { llvm::ConstantInt::get(i32, 0), llvm::ConstantInt::get(i32, i) });
+		while (not symbol->use_empty()) {
+			auto& use = *symbol->use_begin();
+			if (auto expr = llvm::dyn_cast<llvm::ConstantExpr>(use.getUser())) {
+				// Casts of functions mostly, the new instructions are rewritten in the next iterations
+				expand_constant_expression(expr);
+			} else {
+				llvm::IRBuilder<> builder(insertion_point(use));
+				auto address = builder.CreateLoad(slot);
+				use.set(builder.CreatePointerCast(address, symbol->getType()));
+			}
+		}
+	}
+	auto names_type = llvm::ArrayType::get(i8_ptr, names.size());
+	new llvm::GlobalVariable(M, names_type, true, llvm::GlobalValue::ExternalLinkage, llvm::ConstantArray::get(names_type, names), "leekscript_symbol_names");
+	new llvm::GlobalVariable(M, i32, true, llvm::GlobalValue::ExternalLinkage, llvm::ConstantInt::get(i32, names.size()), "leekscript_symbol_count");
+	for (auto symbol : symbols) {
+		symbol->eraseFromParent();
+	}
+}
+
+/*
+ * Optimize and compile a module to an object file, position independent to be linked in a shared library
+ */
+bool Compiler::emit_object(std::unique_ptr<llvm::Module> M, const std::string& file) {
+	std::unique_ptr<llvm::TargetMachine> tm { llvm::EngineBuilder().setRelocationModel(llvm::Reloc::PIC_).selectTarget() };
+	tm->setOptLevel(TM->getOptLevel());
+	M->setDataLayout(tm->createDataLayout());
+	M->setTargetTriple(tm->getTargetTriple().str());
+	M = optimizeModule(std::move(M), *tm);
+
+	std::error_code EC;
+	llvm::raw_fd_ostream object(file, EC, llvm::sys::fs::F_None);
+	if (EC) return false;
+	llvm::legacy::PassManager PM;
+	if (tm->addPassesToEmitFile(PM, object, nullptr, llvm::TargetMachine::CGFT_ObjectFile)) {
+		return false;
+	}
+	PM.run(*M);
+	object.flush();
+	return true;
+}
+
 llvm::AllocaInst* Compiler::CreateEntryBlockAlloca(const std::string& VarName, llvm::Type* type) const {
 	assert(F);
 	llvm::IRBuilder<> builder(&F->getEntryBlock(), F->getEntryBlock().begin());
@@ -123,6 +392,8 @@ llvm::AllocaInst* Compiler::CreateEntryBlockAlloca(const std::string& VarName, l
 void Compiler::init() {
 	mappings.clear();
 	global_strings.clear();
+	interned_strings.clear();
+	stack_arrays.clear();
 }
 void Compiler::end() {}
 
@@ -170,6 +441,34 @@ Compiler::value Compiler::new_const_string(std::string s) {
 	global_strings.insert({ s, str });
 	return str;
 }
+/*
+ * String literal : interned by the VM on the first execution, then loaded from a global.
+ * String.intern fills the global, or leaves it empty once the table of the VM is full.
+ */
+Compiler::value Compiler::new_interned_string(std::string s) {
+	auto type = (llvm::PointerType*) env.string->llvm(*this);
+	auto i = interned_strings.find(s);
+	auto cache = i != interned_strings.end() ? i->second : nullptr;
+	if (!cache) {
+		cache = new llvm::GlobalVariable(*program->module, type, false, llvm::GlobalValue::PrivateLinkage, llvm::ConstantPointerNull::get(type), "string");
+		interned_strings.insert({ s, cache });
+	}
+	auto cached = insn_load({ cache, env.string->pointer() });
+	label label_cached = { builder.GetInsertBlock() };
+	auto label_intern = insn_init_label("string.intern");
+	auto label_end = insn_init_label("string.end");
+	builder.CreateCondBr(insn_pointer_eq(cached, new_null_pointer(env.string)).v, label_intern.block, label_end.block);
+
+	insn_label(&label_intern);
+	auto cache_ptr = value { builder.CreatePointerCast(cache, env.i8_ptr->llvm(*this)), env.i8_ptr };
+	auto interned = insn_call(env.string, { get_vm(), new_const_string(s), cache_ptr }, "String.intern");
+	insn_branch(&label_end);
+
+	insn_label(&label_end);
+	auto r = insn_phi(env.string, cached, label_cached, interned, label_intern);
+	return { r.v, env.tmp_string };
+}
+
 Compiler::value Compiler::new_null_pointer(const Type* type) {
 	assert(type->is_pointer());
 	return { llvm::ConstantPointerNull::get((llvm::PointerType*) type->llvm(*this)), type };
@@ -239,6 +538,45 @@ Compiler::value Compiler::new_array(const Type* element_type, std::vector<Compil
 	return array;
 }
 
+/*
+ * Array that doesn't escape (Value::will_not_escape) : built in a stack slot of the function instead of the heap,
+ * destroyed in place at the end of the current block.
+ */
+Compiler::value Compiler::new_stack_array(const Type* element_type, std::vector<Compiler::value> elements) {
+	auto folded_type = element_type->fold();
+	auto stack_type = [&]() {
+		if (folded_type->is_bool() or folded_type->is_integer() or folded_type->is_long() or folded_type->is_real()) {
+			return Type::array(folded_type);
+		}
+		return Type::array(env.any);
+	}();
+	auto version = [&]() {
+		if (folded_type->is_bool()) return ".0";
+		if (folded_type->is_integer()) return ".1";
+		if (folded_type->is_long()) return ".2";
+		if (folded_type->is_real()) return ".3";
+		return ".4";
+	}();
+	auto slot = CreateEntryBlockAlloca("stack_array", llvm::ArrayType::get(env.i8->llvm(*this), sizeof(LSArray<LSValue*>)));
+	slot->setAlignment(16);
+	value memory = { builder.CreatePointerCast(slot, env.i8_ptr->llvm(*this)), env.i8_ptr };
+	auto stack_array = insn_call(stack_type, {memory, new_integer(elements.size())}, std::string("Array.new_stack") + version);
+	blocks.back().back()->stack_values.push_back(stack_array);
+
+	value array = { builder.CreatePointerCast(stack_array.v, Type::array(element_type)->llvm(*this)), Type::array(element_type) };
+	for (const auto& element : elements) {
+		auto v = insn_move(insn_convert(element, folded_type));
+		insn_push_array(array, v);
+	}
+	// size of the array + 1 operations
+	inc_ops(elements.size() + 1);
+	stack_arrays.insert(array.v);
+	return array;
+}
+bool Compiler::is_stack_array(value array) const {
+	return stack_arrays.find(array.v) != stack_arrays.end();
+}
+
 Compiler::value Compiler::create_entry(const std::string& name, const Type* type) {
 	// std::cout << "create_entry " << type << std::endl;
 	return { CreateEntryBlockAlloca(name, type->llvm(*this)), type->pointer() };
@@ -1234,6 +1572,57 @@ Compiler::value Compiler::insn_array_end(Compiler::value array) {
 	return insn_load_member(array, 6);
 }
 
+/*
+ * Field access with an inline cache : the call site remembers the last (shape, slot) seen by Object.attr_cached,
+ * an object with the same shape loads its slot directly, the others go through Object.attr_cached.
+ */
+Compiler::value Compiler::insn_object_attr(Compiler::value object, const std::string& field, const Type* type) {
+	assert(check_value(object));
+	auto field_type = Type::structure("shape_field", { env.i8_ptr, env.integer });
+	auto cache_type = (llvm::PointerType*) field_type->pointer()->llvm(*this);
+	auto cache = new llvm::GlobalVariable(*program->module, cache_type, false, llvm::GlobalValue::PrivateLinkage, llvm::ConstantPointerNull::get(cache_type), "attr_cache");
+	auto entry = insn_load({ cache, field_type->pointer()->pointer() });
+
+	auto label_check = insn_init_label("attr.check");
+	auto label_hit = insn_init_label("attr.hit");
+	auto label_miss = insn_init_label("attr.miss");
+	auto label_end = insn_init_label("attr.end");
+
+	auto empty = insn_pointer_eq(entry, new_null_pointer(field_type->pointer()));
+	if (object.t->fold()->is_object()) {
+		builder.CreateCondBr(empty.v, label_miss.block, label_check.block);
+	} else {
+		// Any value : check the type byte of the value
+		auto label_type = insn_init_label("attr.type");
+		builder.CreateCondBr(empty.v, label_miss.block, label_type.block);
+		insn_label(&label_type);
+		auto value_type = builder.CreateAnd(insn_load_member(object, 2).v, 0xff);
+		auto is_object = builder.CreateICmpEQ(value_type, new_integer(LSValue::OBJECT).v);
+		builder.CreateCondBr(is_object, label_check.block, label_miss.block);
+	}
+
+	insn_label(&label_check);
+	value as_object = { builder.CreatePointerCast(object.v, env.object->llvm(*this)), env.object };
+	auto shape = insn_load_member(as_object, 5);
+	auto entry_shape = insn_load_member(entry, 0);
+	builder.CreateCondBr(insn_pointer_eq(shape, entry_shape).v, label_hit.block, label_miss.block);
+
+	insn_label(&label_hit);
+	auto slots = builder.CreatePointerCast(insn_load_member(as_object, 6).v, type->llvm(*this)->getPointerTo());
+	value hit = { builder.CreateLoad(builder.CreateGEP(slots, insn_load_member(entry, 1).v)), type };
+	insn_branch(&label_end);
+
+	insn_label(&label_miss);
+	auto k = new_const_string(field);
+	auto cache_ptr = value { builder.CreatePointerCast(cache, env.i8_ptr->llvm(*this)), env.i8_ptr };
+	auto miss = insn_invoke(type, { get_vm(), insn_convert(object, env.any), k, cache_ptr }, "Object.attr_cached");
+	label label_miss_end = { builder.GetInsertBlock() };
+	insn_branch(&label_end);
+
+	insn_label(&label_end);
+	return insn_phi(type, hit, label_hit, miss, label_miss_end);
+}
+
 Compiler::value Compiler::insn_move_inc(Compiler::value value) {
 	assert(check_value(value));
 	if (value.t->is_mpz_ptr()) {
@@ -1865,7 +2254,7 @@ void Compiler::insn_throw(Compiler::value v) {
 
 		auto ex = insn_call(env.i8_ptr, { new_integer(sizeof(vm::ExceptionObj)) }, "__cxa_allocate_exception");
 		auto ex_obj = insn_call(env.i8_ptr, { ex, v, file, function_name, line  }, "System.new_exception");
-		insn_call(env.void_, {ex_obj, new_long((long) &typeid(vm::ExceptionObj)), get_symbol("System.delete_exception", env.i8_ptr)}, "__cxa_throw");
+		insn_call(env.void_, {ex_obj, get_symbol("exception_typeinfo", env.i8_ptr), get_symbol("System.delete_exception", env.i8_ptr)}, "__cxa_throw");
 
 		// insn_call(env.void_, {v, file, function_name, line}, "System.throw");
 	}
@@ -1890,9 +2279,11 @@ void Compiler::insn_branch(Section* s) {
 void Compiler::insn_return(Compiler::value v) {
 	assert(check_value(v));
 	assert(v.v != nullptr);
+	check_ops();
 	builder.CreateRet(v.v);
 }
 void Compiler::insn_return_void() {
+	check_ops();
 	builder.CreateRetVoid();
 }
 
@@ -1965,6 +2356,7 @@ Compiler::value Compiler::insn_invoke(const Type* return_type, std::vector<Compi
 	} else {
 		lambda = p->second.function;
 	}
+	flush_ops();
 	auto continueBlock = llvm::BasicBlock::Create(getContext(), "cont", F);
 	auto r = builder.CreateInvoke(lambda, continueBlock, fun->get_landing_pad(*this), llvm_args);
 	builder.SetInsertPoint(continueBlock);
@@ -1987,6 +2379,7 @@ Compiler::value Compiler::insn_call(Compiler::value fun, std::vector<Compiler::v
 		assert(check_value_not_void(args[i]));
 		llvm_args.push_back(args[i].v);
 	}
+	check_ops();
 	auto r = [&]() { if (dynamic_cast<const Function_object_type*>(fun.t)) {
 		auto convert_type = Type::fun_object(fun.t->return_type(), {});
 		auto fun_to_ptr = builder.CreatePointerCast(fun.v, convert_type->llvm(*this));
@@ -2038,6 +2431,7 @@ Compiler::value Compiler::insn_call(const Type* return_type, std::vector<Compile
 	} else {
 		lambda = p->second.function;
 	}
+	if (not readonly) flush_ops();
 	auto r = builder.CreateCall(lambda, llvm_args);
 	if (return_type->is_void()) {
 		return { env };
@@ -2059,6 +2453,7 @@ Compiler::value Compiler::insn_invoke(const Type* return_type, std::vector<Compi
 		llvm_args.push_back(args[i].v);
 		llvm_types.push_back(args[i].t->llvm(*this));
 	}
+	check_ops();
 	auto continueBlock = llvm::BasicBlock::Create(getContext(), "cont", F);
 	auto r = [&]() { if (dynamic_cast<const Function_object_type*>(func.t)) {
 		auto convert_type = (const Type*) Type::fun(return_type, {});
@@ -2096,6 +2491,7 @@ void Compiler::log(const std::string&& str) { assert(false); }
 void Compiler::enter_block(Block* block) {
 	// std::cout << "enter_block" << std::endl;
 	blocks.back().push_back(block);
+	block->stack_values.clear(); // Values of a previous compilation of the block
 	if (!loops_blocks.empty()) {
 		loops_blocks.back()++;
 	}
@@ -2117,6 +2513,7 @@ void Compiler::leave_block(bool delete_vars) {
 	if (block->sections.size() and block->sections.back()->successors.size() and block->sections.back()->successors[0]->predecessors.size() == 1) {
 		// enter_section(block->sections.back()->successors[0]);
 	}
+	block->stack_values.clear();
 	blocks.back().pop_back();
 	if (!loops_blocks.empty()) {
 		loops_blocks.back()--;
@@ -2198,6 +2595,11 @@ void Compiler::delete_variables_block(int deepness) {
 				insn_delete(value);
 			}
 		}
+		for (const auto& value : blocks.back()[i]->stack_values) {
+			auto element = value.t->element();
+			auto version = element->is_bool() ? ".0" : element->is_integer() ? ".1" : element->is_long() ? ".2" : element->is_real() ? ".3" : ".4";
+			insn_call(env.void_, {value}, std::string("Array.delete_stack") + version);
+		}
 	}
 }
 
@@ -2213,6 +2615,7 @@ void Compiler::enter_function(llvm::Function* F, bool is_closure, FunctionVersio
 	if (!block) block = fun->block;
 	function_llvm_blocks.push(block);
 	exception_line.push(-1);
+	operations_counters.push({ env });
 	this->F = F;
 	this->fun = fun;
 	std::vector<std::string> args;
@@ -2230,6 +2633,7 @@ void Compiler::leave_function() {
 	catchers.pop_back();
 	function_is_closure.pop();
 	exception_line.pop();
+	operations_counters.pop();
 	this->F = functions.top();
 	this->fun = functions2.top();
 	builder.SetInsertPoint(function_llvm_blocks.top());
@@ -2329,6 +2733,13 @@ void Compiler::inc_ops_jit(Compiler::value amount) {
 	// Operations enabled?
 	if (not vm->enable_operations) return;
 
+	// Batched : only add to the local counter, kept in a register after mem2reg
+	if (operations_counters.size() and operations_counters.top().v) {
+		auto counter = operations_counters.top();
+		insn_store(counter, insn_add(insn_load(counter), amount));
+		return;
+	}
+
 	// Get the operations counter global variable
 	auto ops_ptr = get_symbol("operations", env.integer->pointer());
 
@@ -2345,9 +2756,40 @@ void Compiler::inc_ops_jit(Compiler::value amount) {
 	insn_store(ops_ptr, insn_add(jit_ops, amount));
 }
 
+/*
+ * Batched operations : the local counter of the function is added to the global counter before the calls
+ * (the callee and the runtime see the exact count) and the limit is checked at the loops back-edges,
+ * the LeekScript calls and the returns. Consecutive increments are merged by the optimizer.
+ */
+void Compiler::init_ops() {
+	if (not vm->enable_operations or not batch_operations) return;
+	auto counter = create_entry("ops", env.integer);
+	insn_store(counter, new_integer(0));
+	operations_counters.top() = counter;
+}
+void Compiler::flush_ops() {
+	if (operations_counters.empty() or not operations_counters.top().v) return;
+	auto counter = operations_counters.top();
+	auto ops_ptr = get_symbol("operations", env.integer->pointer());
+	insn_store(ops_ptr, insn_add(insn_load(ops_ptr), insn_load(counter)));
+	insn_store(counter, new_integer(0));
+}
+void Compiler::check_ops() {
+	if (operations_counters.empty() or not operations_counters.top().v) return;
+	flush_ops();
+	auto ops = insn_load(get_symbol("operations", env.integer->pointer()));
+	insn_if(insn_gt(ops, new_integer(vm->operation_limit)), [&]() {
+		insn_throw_object(vm::Exception::OPERATION_LIMIT_EXCEEDED);
+	});
+}
+
 /** Exceptions **/
 void Compiler::mark_offset(int line) {
 	exception_line.top() = line;
+	if (profile and builder.GetInsertBlock()) {
+		// Read by the profiler when it takes a sample
+		builder.CreateStore(new_integer(line).v, get_symbol("profile_line", env.integer->pointer()).v, true);
+	}
 }
 void Compiler::insn_try_catch(std::function<void()> try_, std::function<void()> catch_) {
 	Block block { env };
@@ -34,15 +34,26 @@
 #include "llvm/ExecutionEngine/Orc/IRTransformLayer.h"
 #include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
 #include "llvm/Transforms/InstCombine/InstCombine.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/AlwaysInliner.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/CompileOnDemandLayer.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
+#include "llvm/ExecutionEngine/JITEventListener.h"
+#include "llvm/Object/SymbolSize.h"
 #include "../vm/Exception.hpp"
 #include "../vm/LSValue.hpp"
+#include "CodeCache.hpp"
 #include <gmp.h>
+#include <unordered_set>
 
 namespace ls {
 
@@ -99,20 +110,37 @@ public:
 	std::vector<std::vector<std::vector<catcher>>> catchers;
 	std::map<std::pair<std::string, const Type*>, function_entry> mappings;
 	std::stack<int> exception_line;
+	std::stack<value> operations_counters; // Operations not yet added to the global counter, for each function
 	bool export_bitcode = false;
 	bool export_optimized_ir = false;
+	bool optimize = true;
+	int optimization_level = 1;
+	bool lazy = false; // Compile the functions on their first call
+	int compile_threads = 1; // Split the module and compile the parts in parallel if > 1
+	bool batch_operations = false; // Count the operations in a local counter, flushed at the calls and checked at the loops back-edges
+	bool profile = false; // Frame pointers, line markers and registration of the functions for the profiler
+	std::map<llvm::orc::VModuleKey, std::pair<uint64_t, uint64_t>> profiled_objects;
 	std::unordered_map<std::string, Compiler::value> global_strings;
+	std::unordered_map<std::string, llvm::GlobalVariable*> interned_strings;
+	std::unordered_set<llvm::Value*> stack_arrays; // Arrays built by new_stack_array, without refcount
 
 	VM* vm;
 	Program* program;
 
 	std::unique_ptr<llvm::TargetMachine> TM;
 	llvm::DataLayout DL;
+	CodeCache cache;
 	llvm::orc::ExecutionSession ES;
 	llvm::orc::LegacyRTDyldObjectLinkingLayer ObjectLayer;
 	llvm::orc::LegacyIRCompileLayer<decltype(ObjectLayer), llvm::orc::SimpleCompiler> CompileLayer;
 	using OptimizeFunction = std::function<std::unique_ptr<llvm::Module>(std::unique_ptr<llvm::Module>)>;
 	llvm::orc::LegacyIRTransformLayer<decltype(CompileLayer), OptimizeFunction> OptimizeLayer;
+	std::shared_ptr<llvm::orc::SymbolResolver> resolver;
+	std::map<llvm::orc::VModuleKey, std::shared_ptr<llvm::orc::SymbolResolver>> resolvers;
+	std::unique_ptr<llvm::orc::JITCompileCallbackManager> CompileCallbackManager;
+	llvm::orc::LegacyCompileOnDemandLayer<decltype(OptimizeLayer)> CODLayer;
+	std::set<llvm::orc::VModuleKey> lazy_modules;
+	std::map<llvm::orc::VModuleKey, std::vector<llvm::orc::VModuleKey>> parallel_modules;
 
 	Compiler(Environment& env, VM* vm);
 
@@ -120,14 +148,34 @@ public:
 
 	llvm::LLVMContext& getContext() { return *Ctx.getContext(); }
 
+	void set_optimization_level(int level);
 	std::unique_ptr<llvm::Module> optimizeModule(std::unique_ptr<llvm::Module> M);
+	std::unique_ptr<llvm::Module> optimizeModule(std::unique_ptr<llvm::Module> M, llvm::TargetMachine& tm);
 	llvm::orc::VModuleKey addModule(std::unique_ptr<llvm::Module> M, bool optimize, bool export_bitcode = false, bool export_optimized_ir = false);
+	llvm::orc::VModuleKey addModuleParallel(std::unique_ptr<llvm::Module> M, bool optimize);
+	llvm::orc::VModuleKey addObject(std::unique_ptr<llvm::MemoryBuffer> O);
+	void create_symbol_table(llvm::Module& M);
+	void object_loaded(llvm::orc::VModuleKey K, const llvm::object::ObjectFile& object, const llvm::RuntimeDyld::LoadedObjectInfo& info);
+	void object_freed(llvm::orc::VModuleKey K);
+	bool emit_object(std::unique_ptr<llvm::Module> M, const std::string& file);
 
 	llvm::JITSymbol findSymbol(const std::string Name) {
-		return OptimizeLayer.findSymbol(Name, false);
+		// The compile-on-demand layer returns the stubs of the lazy modules, and looks in the optimize layer otherwise
+		return CODLayer.findSymbol(Name, false);
 	}
 	void removeModule(llvm::orc::VModuleKey K) {
-		cantFail(OptimizeLayer.removeModule(K));
+		auto p = parallel_modules.find(K);
+		if (p != parallel_modules.end()) {
+			for (const auto& k : p->second) {
+				cantFail(ObjectLayer.removeObject(k));
+			}
+			parallel_modules.erase(p);
+		} else if (lazy_modules.erase(K)) {
+			cantFail(CODLayer.removeModule(K));
+		} else {
+			cantFail(OptimizeLayer.removeModule(K));
+		}
+		resolvers.erase(K);
 	}
 
 	/// CreateEntryBlockAlloca - Create an alloca instruction in the entry block of the function.  This is used for mutable variables etc.
@@ -145,6 +193,7 @@ public:
 	value new_long(long l);
 	value new_mpz();
 	value new_const_string(std::string s);
+	value new_interned_string(std::string s);
 	value new_null_pointer(const Type* type);
 	value new_function(const Type* type);
 	value new_function(Compiler::value fun);
@@ -238,11 +287,16 @@ public:
 
 	// Arrays
 	value new_array(const Type* type, std::vector<value> elements);
+	value new_stack_array(const Type* type, std::vector<value> elements);
+	bool is_stack_array(value array) const;
 	value insn_array_size(value v);
 	void  insn_push_array(value array, value element);
 	value insn_array_at(value array, value index);
 	value insn_array_end(value array);
 
+	// Objects
+	value insn_object_attr(value object, const std::string& field, const Type* type);
+
 	// Iterators
 	value iterator_begin(value v);
 	value iterator_rbegin(value v);
@@ -315,6 +369,9 @@ public:
 	/** Operations **/
 	void inc_ops(int add);
 	void inc_ops_jit(value add);
+	void init_ops();
+	void flush_ops();
+	void check_ops();
 
 	/** Exceptions **/
 	void mark_offset(int line);
@@ -0,0 +1,282 @@
+#include "RefCountElision.hpp"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Constants.h"
+
+namespace ls {
+
+namespace {
+
+/*
+ * The value whose refs counter is at this address : field 3 of { i32, i32, i32, i32 refs, i1 native, ... }
+ */
+llvm::Value* refs_object(llvm::Value* address) {
+	auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(address);
+	if (not gep or gep->getNumIndices() != 2) return nullptr;
+	auto structure = llvm::dyn_cast<llvm::StructType>(gep->getSourceElementType());
+	if (not structure or structure->getNumElements() < 5) return nullptr;
+	if (not structure->getElementType(3)->isIntegerTy(32) or not structure->getElementType(4)->isIntegerTy(1)) return nullptr;
+	auto first = llvm::dyn_cast<llvm::ConstantInt>(gep->getOperand(1));
+	auto field = llvm::dyn_cast<llvm::ConstantInt>(gep->getOperand(2));
+	if (not first or not field or not first->isZero() or field->getZExtValue() != 3) return nullptr;
+	return gep->getPointerOperand();
+}
+
+bool is_one(llvm::Value* v) {
+	auto c = llvm::dyn_cast<llvm::ConstantInt>(v);
+	return c and c->isOne();
+}
+
+bool is_runtime(const llvm::CallInst* call, const std::string& name) {
+	auto callee = call->getCalledFunction();
+	if (not callee) return false;
+	// A runtime function called with several return types is declared several times : name, name.1, name.2...
+	auto n = callee->getName();
+	return n == name or n.startswith(name + ".");
+}
+
+class Scanner {
+public:
+	struct Increment {
+		llvm::LoadInst* load;
+		llvm::Instruction* add;
+		llvm::StoreInst* store;
+	};
+
+	llvm::Module& module;
+	int elided = 0;
+	std::unordered_map<llvm::Value*, Increment> increments; // Pending increments, by value
+	std::unordered_map<llvm::Value*, llvm::CallInst*> moves; // Pending Value.move / Value.move_inc, by result
+	std::unordered_map<llvm::Value*, llvm::Value*> loaded; // Address => first load since the last store
+	std::unordered_map<llvm::Value*, llvm::Value*> same; // Load => first load of the same address
+
+	Scanner(llvm::Module& module) : module(module) {}
+
+	/*
+	 * Two loads of the same address without a store between give the same value
+	 */
+	llvm::Value* object(llvm::Value* v) {
+		v = v->stripPointerCasts();
+		auto s = same.find(v);
+		return s == same.end() ? v : s->second;
+	}
+
+	// Something may read a refs counter or free a value
+	void barrier() {
+		increments.clear();
+		moves.clear();
+		loaded.clear();
+	}
+
+	void scan(llvm::Instruction& i) {
+		if (removed.count(&i)) return;
+		if (auto load = llvm::dyn_cast<llvm::LoadInst>(&i)) {
+			if (auto o = refs_object(load->getPointerOperand())) {
+				if (not decrement(load, object(o))) {
+					increments.clear();
+					moves.clear();
+				}
+				return;
+			}
+			auto address = object(load->getPointerOperand());
+			auto l = loaded.find(address);
+			if (l == loaded.end()) {
+				loaded.emplace(address, load);
+			} else {
+				same.emplace(load, l->second);
+			}
+			return;
+		}
+		if (auto store = llvm::dyn_cast<llvm::StoreInst>(&i)) {
+			if (auto o = refs_object(store->getPointerOperand())) {
+				moves.clear();
+				if (not increment(store, object(o))) {
+					increments.clear();
+				}
+				return;
+			}
+			// Other stores don't change the refs counters, but the next loads may give other values
+			loaded.clear();
+			return;
+		}
+		if (llvm::isa<llvm::DbgInfoIntrinsic>(&i)) return;
+		if (auto call = llvm::dyn_cast<llvm::CallInst>(&i)) {
+			if (release(call)) return;
+			barrier();
+			if (is_runtime(call, "Value.move.0") or is_runtime(call, "Value.move_inc.0")) {
+				moves.emplace(call, call);
+			}
+			return;
+		}
+		if (i.mayReadOrWriteMemory()) {
+			barrier();
+		}
+	}
+
+	/*
+	 * refs = refs + 1
+	 */
+	bool increment(llvm::StoreInst* store, llvm::Value* o) {
+		auto add = llvm::dyn_cast<llvm::BinaryOperator>(store->getValueOperand());
+		if (not add or add->getOpcode() != llvm::Instruction::Add or not add->hasOneUse() or not is_one(add->getOperand(1))) return false;
+		auto load = llvm::dyn_cast<llvm::LoadInst>(add->getOperand(0));
+		if (not load or not load->hasOneUse()) return false;
+		auto lo = refs_object(load->getPointerOperand());
+		if (not lo or object(lo) != o) return false;
+		increments[o] = { load, add, store };
+		return true;
+	}
+
+	/*
+	 * refs = refs - 1, after a pending increment : the counter is back to the loaded value of the increment
+	 */
+	bool decrement(llvm::LoadInst* load, llvm::Value* o) {
+		auto inc = increments.find(o);
+		if (inc == increments.end() or not load->hasOneUse()) return false;
+		auto sub = llvm::dyn_cast<llvm::BinaryOperator>(*load->user_begin());
+		if (not sub or sub->getOpcode() != llvm::Instruction::Sub or sub->getOperand(0) != load or not is_one(sub->getOperand(1))) return false;
+		llvm::StoreInst* store = nullptr;
+		for (auto user : sub->users()) {
+			auto s = llvm::dyn_cast<llvm::StoreInst>(user);
+			if (s and s->getValueOperand() == sub and s->getParent() == load->getParent()) {
+				auto so = refs_object(s->getPointerOperand());
+				if (so and object(so) == o) store = s;
+			}
+		}
+		if (not store) return false;
+		for (auto i = load->getNextNode(); i != store; i = i->getNextNode()) {
+			if (not i or i->mayReadOrWriteMemory()) return false;
+		}
+		sub->replaceAllUsesWith(inc->second.load);
+		kill_access(store);
+		kill(sub);
+		kill_access(load);
+		kill_access(inc->second.store);
+		kill(inc->second.add);
+		kill_access(inc->second.load);
+		increments.erase(inc);
+		elided += 2;
+		return true;
+	}
+
+	/*
+	 * Value.delete_ref / Value.dec_refs / Value.delete closing a pending increment or move
+	 */
+	bool release(llvm::CallInst* call) {
+		if (call->arg_size() != 1) return false;
+		auto argument = call->getArgOperand(0);
+		auto moved = [&](const std::string& move) -> llvm::CallInst* {
+			auto m = moves.find(argument->stripPointerCasts());
+			if (m == moves.end() or not is_runtime(m->second, move)) return nullptr;
+			// The moved value is only deleted
+			if (not m->second->hasOneUse()) return nullptr;
+			if (argument != m->second) {
+				auto cast = llvm::dyn_cast<llvm::CastInst>(argument);
+				if (not cast or cast->getOperand(0) != m->second or not cast->hasOneUse()) return nullptr;
+			}
+			return m->second;
+		};
+		if (is_runtime(call, "Value.delete_ref.0") or is_runtime(call, "Value.dec_refs.0")) {
+			auto inc = increments.find(object(argument));
+			if (inc != increments.end()) {
+				delete_unowned(call, argument);
+				kill_access(inc->second.store);
+				kill(inc->second.add);
+				kill_access(inc->second.load);
+				elided += 1;
+				barrier();
+				return true;
+			}
+			if (auto move = moved("Value.move_inc.0")) {
+				delete_unowned(call, move->getArgOperand(0));
+				if (argument != move) kill((llvm::Instruction*) argument);
+				kill(move);
+				elided += 2;
+				barrier();
+				return true;
+			}
+			return false;
+		}
+		if (is_runtime(call, "Value.delete.0")) {
+			if (auto move = moved("Value.move.0")) {
+				delete_unowned(call, move->getArgOperand(0));
+				if (argument != move) kill((llvm::Instruction*) argument);
+				kill(move);
+				elided += 2;
+				barrier();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void delete_unowned(llvm::CallInst* call, llvm::Value* value) {
+		auto type = llvm::FunctionType::get(llvm::Type::getVoidTy(module.getContext()), { value->getType() }, false);
+		auto function = module.getOrInsertFunction("Value.delete_unowned.0", type);
+		llvm::CallInst::Create(function, { value }, "", call);
+		kill(call);
+	}
+
+	void erase() {
+		// Killed in order, the users first
+		for (auto i : dead) {
+			if (i->use_empty()) i->eraseFromParent();
+		}
+		dead.clear();
+		removed.clear();
+	}
+
+private:
+	std::vector<llvm::Instruction*> dead;
+	std::unordered_set<llvm::Instruction*> removed;
+
+	void kill(llvm::Instruction* i) {
+		if (removed.insert(i).second) dead.push_back(i);
+	}
+	void kill_access(llvm::Instruction* i) {
+		kill(i);
+		auto address = llvm::isa<llvm::LoadInst>(i) ? ((llvm::LoadInst*) i)->getPointerOperand() : ((llvm::StoreInst*) i)->getPointerOperand();
+		if (auto gep = llvm::dyn_cast<llvm::GetElementPtrInst>(address)) {
+			kill(gep);
+		}
+	}
+};
+
+}
+
+int RefCountElision::run(llvm::Module& module) {
+	int elided = 0;
+	for (auto& function : module) {
+		if (not function.isDeclaration()) {
+			elided += run(function);
+		}
+	}
+	return elided;
+}
+
+int RefCountElision::run(llvm::Function& function) {
+	Scanner scanner { *function.getParent() };
+	std::unordered_set<llvm::BasicBlock*> visited;
+	for (auto& block : function) {
+		// Straight-line runs : a block continues into its successor if it's the only way to get there
+		scanner.barrier();
+		auto b = &block;
+		while (b and visited.insert(b).second) {
+			for (auto& i : *b) {
+				scanner.scan(i);
+			}
+			auto branch = llvm::dyn_cast_or_null<llvm::BranchInst>(b->getTerminator());
+			b = branch and branch->isUnconditional() and branch->getSuccessor(0)->getSinglePredecessor() == b ? branch->getSuccessor(0) : nullptr;
+		}
+	}
+	scanner.erase();
+	return scanner.elided;
+}
+
+}
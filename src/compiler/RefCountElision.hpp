@@ -0,0 +1,30 @@
+#ifndef REF_COUNT_ELISION_HPP
+#define REF_COUNT_ELISION_HPP
+
+namespace llvm {
+	class Module;
+	class Function;
+}
+
+namespace ls {
+
+/*
+ * Removes the redundant reference counting of the generated IR, before the LLVM pipeline.
+ * The optimizer can't do it alone : the releases are calls to the runtime, opaque to it.
+ * In a straight-line run of code where nothing can read a refs counter or free a value :
+ *   - an increment of refs followed by a decrement of the same value : both removed
+ *   - an increment followed by Value.delete_ref / Value.dec_refs : Value.delete_unowned
+ *   - Value.move followed by Value.delete of the moved value : Value.delete_unowned (no clone)
+ *   - Value.move_inc followed by Value.delete_ref of the moved value : Value.delete_unowned
+ * Value.delete_unowned deletes the value if nobody owns it, which is all what remains of each pair.
+ */
+class RefCountElision {
+public:
+	// Number of reference counting operations removed
+	static int run(llvm::Module& module);
+	static int run(llvm::Function& function);
+};
+
+}
+
+#endif
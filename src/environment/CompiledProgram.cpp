@@ -0,0 +1,30 @@
+#include "CompiledProgram.hpp"
+#include "Environment.hpp"
+
+namespace ls {
+
+CompiledProgram::CompiledProgram(Environment& env, const std::string& code, const std::string& file_name, bool ops)
+	: program(new Program(env, code, file_name)), binding(env), ops(ops) {}
+
+bool CompiledProgram::bind(Context* ctx) {
+	if (not ctx) {
+		return binding.vars.empty();
+	}
+	for (auto& var : binding.vars) {
+		auto i = ctx->vars.find(var.first);
+		if (i == ctx->vars.end() or i->second.type != var.second.type) {
+			unbind();
+			return false;
+		}
+		var.second.value = i->second.value;
+	}
+	return true;
+}
+
+void CompiledProgram::unbind() {
+	for (auto& var : binding.vars) {
+		var.second.value.long_value = 0;
+	}
+}
+
+}
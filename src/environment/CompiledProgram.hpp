@@ -0,0 +1,38 @@
+#ifndef COMPILED_PROGRAM_HPP
+#define COMPILED_PROGRAM_HPP
+
+#include <memory>
+#include <string>
+#include "../analyzer/Program.hpp"
+#include "../analyzer/Context.hpp"
+#include "../analyzer/Result.hpp"
+
+namespace ls {
+
+class Environment;
+
+/*
+ * A program analyzed and compiled once, executed many times with
+ * `Environment::execute(CompiledProgram&, Context*)`.
+ * Must be destroyed before its environment.
+ */
+class CompiledProgram {
+public:
+	std::unique_ptr<Program> program;
+	Context binding; // Context variables slots linked in the compiled code
+	Result compilation; // Analysis and compilation results, base of each run result
+	bool ops;
+
+	CompiledProgram(Environment& env, const std::string& code, const std::string& file_name, bool ops);
+
+	bool success() const { return compilation.compilation_success; }
+
+	/** Load the values of a run context in the linked slots, false if the context doesn't match **/
+	bool bind(Context* ctx);
+	/** Release the run context values (still owned by the run context) **/
+	void unbind();
+};
+
+}
+
+#endif
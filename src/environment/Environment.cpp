@@ -1,3 +1,4 @@
+#include <fstream>
 #include "Environment.hpp"
 #include "../type/Void_type.hpp"
 #include "../type/Any_type.hpp"
@@ -35,16 +36,24 @@
 #include "../analyzer/semantic/SemanticAnalyzer.hpp"
 #include "../util/utf8.h"
 #include "../analyzer/resolver/Resolver.hpp"
+#include "../analyzer/Context.hpp"
+#include "CompiledProgram.hpp"
 
 namespace ls {
 
+/*
+ * The type mutators have no state : shared by all the environments of the process
+ */
+static const ChangeValueMutator shared_change_value_mutator;
+static const ConvertMutator shared_convert_mutator;
+static const ConvertMutator shared_convert_mutator_array_size { true };
+
 Environment::Environment() : Environment(false) {}
 
 Environment::Environment(bool legacy) :
 	#if COMPILER
-	compiler(*this, &vm),
 	vm(*this, std),
-	mpz_type(llvm::StructType::create({ llvm::Type::getInt128Ty(compiler.getContext()) }, "mpz")),
+	mpz_type(nullptr),
 	#endif
 	legacy(legacy),
     void_(new Void_type { *this }),
@@ -81,9 +90,9 @@ Environment::Environment(bool legacy) :
     tmp_object(object->add_temporary()),
 	array(Type::array(void_)),
 	set(Type::set(void_)),
-	change_value_mutator(new ChangeValueMutator()),
-	convert_mutator(new ConvertMutator()),
-	convert_mutator_array_size(new ConvertMutator(true)),
+	change_value_mutator(&shared_change_value_mutator),
+	convert_mutator(&shared_convert_mutator),
+	convert_mutator_array_size(&shared_convert_mutator_array_size),
 	std(*this, legacy)
 {}
 
@@ -102,9 +111,6 @@ Environment::~Environment() {
 	delete real;
 	delete interval;
 	delete object;
-	delete change_value_mutator;
-	delete convert_mutator;
-	delete convert_mutator_array_size;
 }
 
 void Environment::analyze(Program& program, bool format, bool debug, bool sections) {
@@ -115,6 +121,12 @@ void Environment::analyze(Program& program, bool format, bool debug, bool sectio
 	delete resolver;
 }
 
+void Environment::edit(Program& program, size_t start, size_t end, const std::string& text) {
+	program.main_file->edit(start, end, text);
+	program.code = program.main_file->code;
+	analyze(program);
+}
+
 Completion Environment::autocomplete(Program& program, size_t position) {
 	SemanticAnalyzer sem { *this };
 	return program.autocomplete(sem, position);
@@ -127,8 +139,23 @@ Hover Environment::hover(Program& program, File* file, size_t position) {
 
 #if COMPILER
 
+Compiler& Environment::compiler() {
+	if (not jit) {
+		jit = std::make_unique<Compiler>(*this, &vm);
+		mpz_type = llvm::StructType::create({ llvm::Type::getInt128Ty(jit->getContext()) }, "mpz");
+	}
+	return *jit;
+}
+
 void Environment::compile(Program& program, bool format, bool debug, bool ops, bool assembly, bool pseudo_code, bool optimized_ir, bool execute_ir, bool execute_bitcode) {
 	vm.enable_operations = ops or operation_limit > 0;
+	auto& compiler = this->compiler();
+	compiler.set_optimization_level(optimization);
+	compiler.cache.directory = cache_directory;
+	compiler.lazy = lazy;
+	compiler.compile_threads = compile_threads;
+	compiler.profile = not profile_output.empty();
+	compiler.batch_operations = batch_operations;
 	program.compile(compiler, format, debug, assembly, pseudo_code, optimized_ir, execute_ir, execute_bitcode);
 }
 
@@ -140,23 +167,74 @@ void Environment::execute(Program& program, bool format, bool debug, bool ops, b
 	if (operation_limit != -1) {
 		vm.operation_limit = operation_limit;
 	}
+	vm.profiler.enabled = not profile_output.empty();
 	vm.execute(program, format, debug, ops, assembly, pseudo_code, optimized_ir, execute_ir, execute_bitcode);
+	if (vm.profiler.enabled and program.result.compilation_success) {
+		std::ofstream file(profile_output);
+		vm.profiler.write_folded(file);
+	}
+}
+
+void Environment::compile_native(Program& program, const std::string& output) {
+	vm.enable_operations = operation_limit > 0;
+	auto& compiler = this->compiler();
+	compiler.set_optimization_level(optimization);
+	compiler.batch_operations = batch_operations;
+	program.compile_native(compiler, output);
+}
+
+void Environment::load_native(Program& program) {
+	program.load_native(vm);
+}
+
+std::unique_ptr<CompiledProgram> Environment::compile(const std::string& code, const std::string& file_name, Context* ctx, bool ops) {
+	auto compiled = std::make_unique<CompiledProgram>(*this, code, file_name, ops);
+	auto& program = *compiled->program;
+	if (ctx) {
+		for (const auto& var : ctx->vars) {
+			compiled->binding.vars.insert({ var.first, ContextVar { ContextVarValue(0l), var.second.type, nullptr, nullptr } });
+		}
+		program.context = &compiled->binding;
+	}
+	analyze(program);
+	compile(program, false, false, ops);
+	compiled->compilation = program.result;
+	return compiled;
+}
+
+Result Environment::execute(CompiledProgram& compiled, Context* ctx) {
+	auto& program = *compiled.program;
+	program.result = compiled.compilation;
+	if (not compiled.success()) {
+		return program.result;
+	}
+	if (not compiled.bind(ctx)) {
+		program.result.exception = vm::ExceptionObj(vm::Exception::WRONG_ARGUMENT_TYPE);
+		return program.result;
+	}
+	// Exported variables go to the run context
+	program.context = ctx;
+	execute(program, false, false, compiled.ops);
+	program.context = compiled.binding.vars.size() ? &compiled.binding : nullptr;
+	compiled.unbind();
+	return program.result;
 }
 
 #endif
 
 const Type* Environment::generate_new_placeholder_type() {
-	uint32_t character = 0x03B1 + Type::placeholder_counter;
+	uint32_t character = 0x03B1 + placeholder_counter;
 	char buff[5];
 	u8_toutf8(buff, 5, &character, 1);
 	auto type = new Placeholder_type(*this, std::string { buff });
-	Type::placeholder_counter++;
+	placeholder_counter++;
 	Environment::placeholder_types.push_back(std::unique_ptr<Placeholder_type> { type });
 	return type;
 }
 
 void Environment::clear_placeholder_types() {
 	placeholder_types.clear();
+	placeholder_counter = 0;
 }
 
 const Type* Environment::template_(std::string name) {
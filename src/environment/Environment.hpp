@@ -18,16 +18,20 @@ namespace ls {
 class Type;
 class OutputStream;
 class Program;
+class CompiledProgram;
+class Context;
 
 class Environment {
 	friend Type;
 private:
 	#if COMPILER
-	Compiler compiler;
+	std::unique_ptr<Compiler> jit; // Built at the first compilation : running a native program doesn't need it
 	VM vm;
+	Compiler& compiler();
 	#endif
 
 	std::vector<std::unique_ptr<const Type>> placeholder_types;
+	unsigned int placeholder_counter = 0;
 	std::map<std::set<const Type*>, std::unique_ptr<const Type>> compound_types;
 	std::map<const Type*, std::unique_ptr<const Type>> tmp_compound_types;
 	std::vector<std::unique_ptr<const Type>> raw_function_types;
@@ -67,6 +71,12 @@ public:
 	bool legacy = false;
 	OutputStream* output = nullptr;
 	int operation_limit = -1;
+	int optimization = 1; // LLVM optimization level (0 to 3)
+	std::string cache_directory; // On-disk code cache, disabled if empty
+	bool lazy = false; // Compile the functions on their first call
+	int compile_threads = 1; // Optimize and generate the code of the program on several threads
+	bool batch_operations = false; // Count the operations in a local counter and check the limit at the loops and calls only
+	std::string profile_output; // Profile the execution and write the folded stacks in this file, disabled if empty
 
     const Type* const void_;
 	const Type* const boolean;
@@ -136,6 +146,12 @@ public:
 	 */
 	void analyze(Program& program, bool format = false, bool debug = false, bool sections = false);
 
+	/**
+	 * Edit the code of an analyzed `Program` (replace the characters [start, end) by a text) and analyze it again,
+	 * the tokens are updated incrementally
+	 */
+	void edit(Program& program, size_t start, size_t end, const std::string& text);
+
 	/**
 	 * Autocomplete a `Program` at a position
 	 */
@@ -156,6 +172,28 @@ public:
 	 * Execute a `Program`.
 	 */
 	void execute(Program& program, bool format = false, bool debug = false, bool ops = true, bool assembly = false, bool pseudo_code = false, bool optimized_ir = false, bool execute_ir = false, bool execute_bitcode = false);
+
+	/**
+	 * Analyze and compile a code once, the handle can be executed many times.
+	 * The context only gives the names and types of the context variables.
+	 */
+	std::unique_ptr<CompiledProgram> compile(const std::string& code, const std::string& file_name = "snippet", Context* ctx = nullptr, bool ops = false);
+
+	/**
+	 * Execute a compiled program with a context, each run gets its own result.
+	 * The context must have the variables (same names and types) used at compilation.
+	 */
+	Result execute(CompiledProgram& compiled, Context* ctx = nullptr);
+
+	/**
+	 * Compile an analyzed `Program` ahead of time to an object file (.o) or a shared library (.so).
+	 */
+	void compile_native(Program& program, const std::string& output);
+
+	/**
+	 * Load a shared library produced by `compile_native` (the program file name), then `execute` it.
+	 */
+	void load_native(Program& program);
 	#endif
 
 	const Type* template_(std::string name);
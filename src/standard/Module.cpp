@@ -21,6 +21,7 @@ int Module::NO_RETURN = 8;
 int Module::EMPTY_VARIABLE = 16;
 int Module::PRIVATE = 32;
 int Module::LEGACY_ONLY = LEGACY + 64;
+int Module::STACK_RESULT = 128;
 
 bool Module::STORE_ARRAY_SIZE = true;
 
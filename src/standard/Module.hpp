@@ -47,6 +47,7 @@ public:
 	static int NO_RETURN;
 	static int PRIVATE;
 	static int LEGACY_ONLY;
+	static int STACK_RESULT; // The result doesn't escape (Value::will_not_escape), can be built on the stack
 
 	static bool STORE_ARRAY_SIZE;
 
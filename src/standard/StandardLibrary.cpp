@@ -43,4 +43,51 @@ void StandardLibrary::add_class(std::unique_ptr<Module> m) {
 	classes.insert({ m->name, std::move(m) });
 }
 
+#if COMPILER
+/*
+ * Names generated by the compiler : "Class.method.version" ("Class.method" for the version 0),
+ * "Class.operator+.version", "Class.field" ("Class.field.0" when called), and "Class" for the class itself.
+ * A method hides a static field and a field with the same name.
+ */
+void StandardLibrary::build_symbols() {
+	symbols.clear();
+	for (const auto& m : classes) {
+		const auto& module = m.second;
+		symbols.emplace(m.first, module->lsclass);
+		auto add = [&](const std::string& name, void* addr) {
+			if (addr) symbols.emplace(m.first + "." + name, addr);
+		};
+		auto add_callable = [&](const std::string& name, const Callable& callable) {
+			for (size_t v = 0; v < callable.versions.size(); ++v) {
+				add(name + "." + std::to_string(v), callable.versions[v].addr);
+			}
+			if (callable.versions.size()) {
+				add(name, callable.versions[0].addr);
+			}
+		};
+		for (const auto& op : module->clazz->operators) {
+			add_callable("operator" + op.first, op.second);
+		}
+		for (const auto& method : module->clazz->methods) {
+			add_callable(method.first, method.second);
+		}
+		for (const auto& field : module->clazz->static_fields) {
+			auto addr = field.second.native_fun ? field.second.native_fun : field.second.addr;
+			add(field.first, addr);
+			add(field.first + ".0", addr);
+		}
+		for (const auto& field : module->clazz->fields) {
+			add(field.first, field.second.native_fun);
+			add(field.first + ".0", field.second.native_fun);
+		}
+	}
+}
+
+void* StandardLibrary::symbol(const std::string& name) {
+	std::call_once(symbols_built, [&]() { build_symbols(); });
+	auto s = symbols.find(name);
+	return s != symbols.end() ? s->second : nullptr;
+}
+#endif
+
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "../analyzer/semantic/Class.hpp"
 #include <unordered_map>
+#include <mutex>
 #include "Module.hpp"
 
 namespace ls {
@@ -17,6 +18,21 @@ public:
 
 	StandardLibrary(Environment& env, bool legacy = false);
 	void add_class(std::unique_ptr<Module> m);
+	#if COMPILER
+	/*
+	 * Address of a runtime symbol, nullptr if unknown.
+	 * The table is built at the first lookup : an environment only used to analyze never pays for it.
+	 */
+	void* symbol(const std::string& name);
+	#endif
+
+private:
+	#if COMPILER
+	// Address of every runtime symbol linked by the JIT ("Array.sort.2", "Number.pi", "Array"...)
+	std::unordered_map<std::string, void*> symbols;
+	void build_symbols();
+	std::once_flag symbols_built; // The JIT may resolve from the compilation threads
+	#endif
 };
 
 }
@@ -4,6 +4,7 @@
 #include "../TypeMutator.hpp"
 #include "../../type/Type.hpp"
 #include "../../analyzer/semantic/Variable.hpp"
+#include "../../analyzer/semantic/CallableVersionTemplate.hpp"
 #include "../../environment/Environment.hpp"
 #if COMPILER
 #include "../../vm/value/LSNumber.hpp"
@@ -421,6 +422,22 @@ ArraySTD::ArraySTD(Environment& env) : Module(env, "Array") {
 		{env.void_, {Type::array(env.any), env.any}, ADDR((void*) LSArray<LSValue*>::std_push_inc)},
 	}, PRIVATE | LEGACY);
 
+	method("new_stack", {
+		{Type::array(env.boolean), {env.i8_ptr, env.integer}, ADDR((void*) LSArray<char>::stack_constructor)},
+		{Type::array(env.integer), {env.i8_ptr, env.integer}, ADDR((void*) LSArray<int>::stack_constructor)},
+		{Type::array(env.long_), {env.i8_ptr, env.integer}, ADDR((void*) LSArray<long>::stack_constructor)},
+		{Type::array(env.real), {env.i8_ptr, env.integer}, ADDR((void*) LSArray<double>::stack_constructor)},
+		{Type::array(env.any), {env.i8_ptr, env.integer}, ADDR((void*) LSArray<LSValue*>::stack_constructor)},
+	}, PRIVATE | LEGACY);
+
+	method("delete_stack", {
+		{env.void_, {Type::array(env.boolean)}, ADDR((void*) LSArray<char>::stack_destructor)},
+		{env.void_, {Type::array(env.integer)}, ADDR((void*) LSArray<int>::stack_destructor)},
+		{env.void_, {Type::array(env.long_)}, ADDR((void*) LSArray<long>::stack_destructor)},
+		{env.void_, {Type::array(env.real)}, ADDR((void*) LSArray<double>::stack_destructor)},
+		{env.void_, {Type::array(env.any)}, ADDR((void*) LSArray<LSValue*>::stack_destructor)},
+	}, PRIVATE | LEGACY);
+
 	method("convert_key", {
 		{env.integer, {env.const_any}, ADDR((void*) convert_key)}
 	}, PRIVATE | LEGACY);
@@ -692,7 +709,7 @@ Compiler::value ArraySTD::map(Compiler& c, std::vector<Compiler::value> args, in
 	auto array = args[0];
 	auto function = args[1];
 	auto return_type = function.t->return_type()->is_void() ? c.env.null : function.t->return_type();
-	auto result = flags & NO_RETURN ? Compiler::value { c.env } : c.new_array(return_type, {});
+	auto result = flags & NO_RETURN ? Compiler::value { c.env } : flags & STACK_RESULT ? c.new_stack_array(return_type, {}) : c.new_array(return_type, {});
 	auto v = Variable::new_temporary("v", array.t->element());
 	c.insn_foreach(array, c.env.void_, &v, nullptr, [&](Compiler::value v, Compiler::value k) -> Compiler::value {
 		auto x = c.clone(v);
@@ -844,9 +861,9 @@ Compiler::value ArraySTD::push(Compiler& c, std::vector<Compiler::value> args, i
 	else return args[0];
 }
 
-Compiler::value ArraySTD::filter(Compiler& c, std::vector<Compiler::value> args, int) {
+Compiler::value ArraySTD::filter(Compiler& c, std::vector<Compiler::value> args, int flags) {
 	auto function = args[1];
-	auto result = c.new_array(args[0].t->element(), {});
+	auto result = flags & STACK_RESULT ? c.new_stack_array(args[0].t->element(), {}) : c.new_array(args[0].t->element(), {});
 	auto v = Variable::new_temporary("v", args[0].t->element());
 	v.create_entry(c);
 	c.insn_foreach(args[0], c.env.void_, &v, nullptr, [&](Compiler::value v, Compiler::value k) -> Compiler::value {
@@ -859,6 +876,123 @@ Compiler::value ArraySTD::filter(Compiler& c, std::vector<Compiler::value> args,
 	return result;
 }
 
+ArraySTD::Stage ArraySTD::stage(const CallableVersion& version) {
+	auto t = version.template_();
+	if (t->mutators.size()) return Stage::NONE;
+	if (t->func) {
+		auto f = t->func.target<Compiler::value(*)(Compiler&, std::vector<Compiler::value>, int)>();
+		if (not f) return Stage::NONE;
+		// arrayMap(f(x, i)) shares the compiler function of map
+		if (*f == map and version.type->argument(1)->arguments().size() == 1) return Stage::MAP;
+		if (*f == filter) return Stage::FILTER;
+		if (*f == fold_left) return Stage::FOLD_LEFT;
+		if (*f == iter) return Stage::ITER;
+	}
+	if (t->addr == (void*) LSArray<int>::ls_sum or t->addr == (void*) LSArray<double>::ls_sum) return Stage::SUM;
+	return Stage::NONE;
+}
+
+/*
+ * The elements of the container go one by one through all the stages, without the intermediate arrays.
+ * Only the last stage builds a container (map, filter) or an accumulator (foldLeft, sum).
+ * An element produced by a map is held during the next stages, and released after.
+ */
+Compiler::value ArraySTD::pipeline(Compiler& c, const Type* type, Compiler::value container, std::vector<Stage> stages, std::vector<std::vector<Compiler::value>> args, int flags) {
+	auto last = stages.size() - 1;
+	auto terminal = stages[last];
+	const auto& terminal_args = args[last];
+	auto no_return = flags & NO_RETURN;
+
+	auto new_result = [&](const Type* element) {
+		return flags & STACK_RESULT ? c.new_stack_array(element, {}) : c.new_array(element, {});
+	};
+	Compiler::value result { c.env };
+	if (terminal == Stage::MAP and not no_return) {
+		auto return_type = terminal_args[0].t->return_type();
+		result = new_result(return_type->is_void() ? c.env.null : return_type);
+	} else if (terminal == Stage::FILTER and not no_return) {
+		result = new_result(terminal_args[0].t->argument(0));
+	}
+	auto accumulator_type = terminal == Stage::FOLD_LEFT ? terminal_args[0].t->argument(0) : terminal == Stage::SUM ? type : c.env.void_;
+	auto accumulator = Variable::new_temporary("r", accumulator_type);
+	if (terminal == Stage::FOLD_LEFT) {
+		accumulator.create_entry(c);
+		c.insn_store(accumulator.entry, c.insn_convert(c.insn_move_inc(terminal_args[1]), accumulator_type));
+	} else if (terminal == Stage::SUM) {
+		accumulator.create_entry(c);
+		c.insn_store(accumulator.entry, c.insn_convert(c.new_integer(0), accumulator_type));
+	}
+
+	std::function<void(size_t, Compiler::value)> stage = [&](size_t i, Compiler::value v) {
+		auto function = args[i].size() ? args[i][0] : Compiler::value { c.env };
+		switch (stages[i]) {
+		case Stage::MAP: {
+			auto x = i == 0 ? c.clone(v) : v;
+			if (i == 0) c.insn_inc_refs(x);
+			auto r = c.insn_call(function, {x});
+			if (i < last) {
+				if (r.t->is_void()) r = c.new_null();
+				c.insn_inc_refs(r);
+				stage(i + 1, r);
+				c.insn_delete(r);
+			} else if (no_return) {
+				if (not r.t->is_void()) c.insn_delete_temporary(r);
+			} else {
+				c.insn_push_array(result, r.t->is_void() ? c.new_null() : r);
+			}
+			if (i == 0) c.insn_delete(x);
+			break;
+		}
+		case Stage::FILTER: {
+			auto r = c.insn_call(function, {v});
+			c.insn_if(r, [&]() {
+				if (i < last) {
+					stage(i + 1, v);
+				} else if (not no_return) {
+					c.insn_push_array(result, c.clone(v));
+				}
+			});
+			break;
+		}
+		case Stage::FOLD_LEFT: {
+			auto r = c.insn_call(function, { c.insn_load(accumulator.entry), v });
+			c.insn_delete(c.insn_load(accumulator.entry));
+			c.insn_store(accumulator.entry, c.insn_move_inc(r));
+			break;
+		}
+		case Stage::ITER: {
+			auto r = c.insn_call(function, {v});
+			if (not r.t->is_void()) c.insn_delete_temporary(r);
+			break;
+		}
+		case Stage::SUM: {
+			c.insn_store(accumulator.entry, c.insn_add(c.insn_load(accumulator.entry), c.insn_convert(v, accumulator_type)));
+			break;
+		}
+		case Stage::NONE: assert(false);
+		}
+	};
+	auto v = Variable::new_temporary("v", container.t->element());
+	v.create_entry(c);
+	c.insn_foreach(container, c.env.void_, &v, nullptr, [&](Compiler::value v, Compiler::value k) -> Compiler::value {
+		stage(0, v);
+		return { c.env };
+	});
+
+	if (terminal == Stage::FOLD_LEFT) {
+		auto r = c.insn_load(accumulator.entry);
+		c.insn_dec_refs(r);
+		return r;
+	}
+	if (terminal == Stage::SUM) {
+		return c.insn_load(accumulator.entry);
+	}
+	if (no_return or terminal == Stage::ITER) {
+		return { c.env };
+	}
+	return result;
+}
+
 Compiler::value ArraySTD::push_all(Compiler& c, std::vector<Compiler::value> args, int) {
 	auto& array1 = args[0];
 	auto& array2 = args[1];
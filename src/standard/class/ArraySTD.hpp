@@ -48,6 +48,13 @@ public:
 	static Compiler::value repeat(Compiler&, std::vector<Compiler::value>, int);
 	static Compiler::value layer(Compiler&, std::vector<Compiler::value>, int);
 
+	/*
+	 * Stages of a fused pipeline : a.map(f).filter(g).sum() compiled as a single loop over a
+	 */
+	enum class Stage { NONE, MAP, FILTER, FOLD_LEFT, ITER, SUM };
+	static Stage stage(const CallableVersion& version);
+	static Compiler::value pipeline(Compiler& c, const Type* type, Compiler::value container, std::vector<Stage> stages, std::vector<std::vector<Compiler::value>> args, int flags);
+
 	static int convert_key(LSValue*);
 
 	#endif
@@ -60,11 +60,15 @@ ObjectSTD::ObjectSTD(Environment& env) : Module(env, "Object") {
 	method("add_field", {
 		{env.void_, {env.object, env.i8_ptr, env.any}, ADDR((void*) LSObject::std_add_field)}
 	}, PRIVATE);
+
+	method("attr_cached", {
+		{env.any, {env.i8_ptr, env.any, env.i8_ptr, env.i8_ptr}, ADDR((void*) LSObject::attr_cached)}
+	}, PRIVATE | LEGACY);
 }
 
 ObjectSTD::~ObjectSTD() {
 	#if COMPILER
-	readonly->values.clear();
+	readonly->slots.clear();
 	#endif
 }
 
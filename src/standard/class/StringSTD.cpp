@@ -13,6 +13,7 @@
 #include "../../vm/value/LSArray.hpp"
 #include "../../vm/value/LSMap.hpp"
 #include "../../vm/VM.hpp"
+#include "../../vm/StringTable.hpp"
 #endif
 
 namespace ls {
@@ -35,6 +36,14 @@ LSValue* string_begin_code_ptr(const LSString*);
 int string_code(const LSString*, int pos);
 long string_number(const LSString*);
 
+LSString* string_intern(VM* vm, char* s, LSString** cache) {
+	if (auto interned = vm->strings.get(s)) {
+		return *cache = interned;
+	}
+	// Table full : a new string at each evaluation
+	return new LSString(s);
+}
+
 LSString* plus_any(LSString* s, LSValue* v) {
 	return (LSString*) s->add(v);
 }
@@ -69,6 +78,7 @@ LSString* iterator_get(unsigned int c, LSString* previous) {
 	// if (previous != nullptr) {
 		// LSValue::delete_ref(previous);
 	// }
+	if (c > 0 and c < 128 and StringTable::current) return StringTable::current->get((char) c);
 	char dest[5];
 	u8_toutf8(dest, 5, &c, 1);
 	auto s = new LSString(dest);
@@ -276,6 +286,11 @@ StringSTD::StringSTD(Environment& env) : Module(env, "String") {
 	method("iterator_next", {
 		{env.void_, {env.i8_ptr}, ADDR((void*) &LSString::iterator_next)}
 	}, PRIVATE);
+
+	method("intern", {
+		{env.string, {env.i8_ptr, env.i8_ptr, env.i8_ptr}, ADDR((void*) string_intern)}
+	}, PRIVATE | LEGACY);
+
 	method("internal_plus_mpz_tmp", {
 		{env.string, {env.i8_ptr, env.tmp_mpz_ptr, env.tmp_string}, ADDR((void*) internal_plus_mpz_tmp)}
 	}, PRIVATE);
@@ -360,7 +375,7 @@ Compiler::value StringSTD::plus_mpz_tmp(Compiler& c, std::vector<Compiler::value
  * Methods
  */
 LSValue* string_charAt(LSString* string, int index) {
-	LSValue* r = new LSString(string->operator[] (index));
+	LSValue* r = StringTable::character(string->operator[] (index));
 	LSValue::delete_temporary(string);
 	return r;
 }
@@ -453,7 +468,7 @@ LSArray<LSValue*>* string_split(LSString* string, LSString* delimiter) {
 	auto parts = new LSArray<LSValue*>();
 	if (*delimiter == "") {
 		for (char c : *string) {
-			parts->push_inc(new LSString(c));
+			parts->push_inc(StringTable::character(c));
 		}
 		if (string->refs == 0) {
 			delete string;
@@ -586,6 +601,8 @@ LSValue* StringSTD::string_right(LSString* string, int pos) {
 	return r;
 }
 LSValue* StringSTD::string_right_tmp(LSString* string, int pos) {
+	// An interned string (literal, character) is shared : not modified in place
+	if (string->native) return string_right(string, pos);
 	return &string->operator = (string->substr(string->size() - std::min(string->size(), (size_t) std::max(0, pos))));
 }
 
@@ -595,6 +612,7 @@ LSValue* StringSTD::string_left(LSString* string, int pos) {
 	return r;
 }
 LSValue* StringSTD::string_left_tmp(LSString* string, int pos) {
+	if (string->native) return string_left(string, pos);
 	return &string->operator = (string->substr(0, std::max(0, pos)));
 }
 
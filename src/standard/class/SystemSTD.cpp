@@ -14,6 +14,7 @@ SystemSTD::SystemSTD(Environment& env) : Module(env, "System") {
 
 	static_field("version", env.integer, ADDR(version));
 	static_field("operations", env.integer, ADDR([&](ls::Compiler& c) {
+		c.flush_ops();
 		return c.insn_load(c.get_symbol("operations", env.integer->pointer()));
 	}));
 	static_field_fun("time", env.long_, ADDR((void*) time));
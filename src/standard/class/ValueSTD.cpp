@@ -305,6 +305,10 @@ ValueSTD::ValueSTD(Environment& env) : Module(env, "Value") {
 		{env.void_, {env.const_any}, ADDR((void*) &LSValue::delete_ref2)}
 	}, PRIVATE | LEGACY);
 
+	method("delete_unowned", {
+		{env.void_, {env.const_any}, ADDR((void*) &LSValue::delete_unowned)}
+	}, PRIVATE | LEGACY);
+
 	method("not", {
 		{env.boolean, {env.const_any}, ADDR((void*) ls_not)}
 	}, PRIVATE | LEGACY);
@@ -624,6 +628,7 @@ int ValueSTD::ls_bit_and_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (int) a->value & (int) b->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -650,6 +655,7 @@ int ValueSTD::ls_bit_or_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (int) a->value | (int) b->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -676,6 +682,7 @@ int ValueSTD::ls_bit_xor_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (int) a->value ^ (int) b->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -703,6 +710,7 @@ int ValueSTD::ls_bit_shift_left_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (int) a->value << (int) b->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -729,6 +737,7 @@ int ValueSTD::ls_bit_shift_right_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (int) a->value >> (int) b->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -756,6 +765,7 @@ int ValueSTD::ls_bit_shift_uright_eq(LSValue** x, LSValue* y) {
 	}
 	auto res = (uint32_t) ((LSNumber*) a)->value >> (uint32_t) ((LSNumber*) b)->value;
 	LSValue::delete_temporary(y);
+	LSNumber::unshare(x);
 	((LSNumber*) *x)->value = res;
 	return res;
 }
@@ -859,9 +869,11 @@ LSValue* ValueSTD::ls_pre_inc(LSValue* x) {
 	return x->ls_preinc();
 }
 LSValue* ValueSTD::ls_incl(LSValue** x) {
+	LSNumber::unshare(x);
 	return (*x)->ls_inc();
 }
 LSValue* ValueSTD::ls_pre_incl(LSValue** x) {
+	LSNumber::unshare(x);
 	return (*x)->ls_preinc();
 }
 LSValue* ValueSTD::ls_dec(LSValue* x) {
@@ -871,9 +883,11 @@ LSValue* ValueSTD::ls_pre_dec(LSValue* x) {
 	return x->ls_predec();
 }
 LSValue* ValueSTD::ls_decl(LSValue** x) {
+	LSNumber::unshare(x);
 	return (*x)->ls_dec();
 }
 LSValue* ValueSTD::ls_pre_decl(LSValue** x) {
+	LSNumber::unshare(x);
 	return (*x)->ls_predec();
 }
 LSValue* ValueSTD::ls_pre_tilde(LSValue* v) {
@@ -883,48 +897,57 @@ LSValue* ValueSTD::ls_add(LSValue* x, LSValue* y) {
 	return x->add(y);
 }
 LSValue* ValueSTD::ls_add_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
+	LSString::unshare(x);
 	return (*x)->add_eq(y);
 }
 LSValue* ValueSTD::ls_sub(LSValue* x, LSValue* y) {
 	return x->sub(y);
 }
 LSValue* ValueSTD::ls_sub_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->sub_eq(y);
 }
 LSValue* ValueSTD::ls_mul(LSValue* x, LSValue* y) {
 	return x->mul(y);
 }
 LSValue* ValueSTD::ls_mul_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->mul_eq(y);
 }
 LSValue* ValueSTD::ls_div(LSValue* x, LSValue* y) {
 	return x->div(y);
 }
 LSValue* ValueSTD::ls_div_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->div_eq(y);
 }
 LSValue* ValueSTD::ls_int_div(LSValue* x, LSValue* y) {
 	return x->int_div(y);
 }
 LSValue* ValueSTD::ls_int_div_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->int_div_eq(y);
 }
 LSValue* ValueSTD::ls_mod(LSValue* x, LSValue* y) {
 	return x->mod(y);
 }
 LSValue* ValueSTD::ls_mod_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->mod_eq(y);
 }
 LSValue* ValueSTD::ls_double_mod(LSValue* x, LSValue* y) {
 	return x->double_mod(y);
 }
 LSValue* ValueSTD::ls_double_mod_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->double_mod_eq(y);
 }
 LSValue* ValueSTD::ls_pow(LSValue* x, LSValue* y) {
 	return x->pow(y);
 }
 LSValue* ValueSTD::ls_pow_eq(LSValue** x, LSValue* y) {
+	LSNumber::unshare(x);
 	return (*x)->pow_eq(y);
 }
 
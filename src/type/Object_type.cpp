@@ -12,7 +12,11 @@ Object_type::Object_type(Environment& env, bool native) : Pointer_type(Type::str
 	env.integer, // ?
 	env.integer, // ?
 	env.integer, // refs
-	env.boolean // native
+	env.boolean, // native
+	env.i8_ptr, // shape
+	env.i8_ptr, // slots.begin
+	env.i8_ptr, // slots.end
+	env.i8_ptr // slots.capacity
 }), native) {}
 
 bool Object_type::operator == (const Type* type) const {
@@ -47,7 +47,6 @@
 
 namespace ls {
 
-unsigned int Type::placeholder_counter = 0;
 const std::vector<const Type*> Type::empty_types;
 
 Type::Type(Environment& env, bool native) : env(env), native(native) {
@@ -125,8 +125,6 @@ public:
 
 	virtual Type* clone() const = 0;
 
-	static unsigned int placeholder_counter;
-
 	// Const types to be used to optimize return of references
 	static const std::vector<const Type*> empty_types;
 
@@ -27,8 +27,8 @@ LSValueType LSValue::CLOSURE = 12;
 LSValueType LSValue::MPZ = 13;
 LSValueType LSValue::LEGACY_ARRAY = 14;
 
-int LSValue::obj_count = 0;
-int LSValue::obj_deleted = 0;
+thread_local int LSValue::obj_count = 0;
+thread_local int LSValue::obj_deleted = 0;
 
 LSValue::LSValue(LSValueType type, int refs, bool native) : type(type), refs(refs), native(native) {
 	if (not native) {
@@ -236,6 +236,10 @@ bool LSValue::lt(const LSValue* v) const {
 	return type < v->type;
 }
 
+size_t LSValue::hash() const {
+	return type;
+}
+
 bool LSValue::in(const LSValue* const v) const {
 	delete_temporary(v);
 	delete_temporary(this);
@@ -8,6 +8,7 @@
 #include <map>
 #include "../util/json.hpp"
 #include "../constants.h"
+#include "Pool.hpp"
 
 namespace ls {
 
@@ -45,11 +46,12 @@ public:
 	static LSValueType MPZ;
 	static LSValueType LEGACY_ARRAY;
 
-	static int obj_count;
-	static int obj_deleted;
+	// Objects counters, per thread : each thread runs its own environment
+	static thread_local int obj_count;
+	static thread_local int obj_deleted;
 	#if DEBUG_LEAKS
 		static std::unordered_map<void*, LSValue*>& objs() {
-			static std::unordered_map<void*, LSValue*> objs;
+			static thread_local std::unordered_map<void*, LSValue*> objs;
 			return objs;
 		}
 	#endif
@@ -62,6 +64,13 @@ public:
 	LSValue(const LSValue& other);
 	virtual ~LSValue() = 0;
 
+	// Allocated in the pool of the running execution, a header keeps the pool (or nullptr for the heap)
+	static void* operator new(size_t size);
+	static void operator delete(void* value, size_t size);
+	// Values built in place (containers on the stack of the compiled code)
+	static void* operator new(size_t, void* memory) { return memory; }
+	static void operator delete(void*, void*) {}
+
 	static LSValue* std_move(LSValue* value);
 	static LSValue* std_move_inc(LSValue* value);
 
@@ -118,6 +127,8 @@ public:
 		return !(*this < value);
 	}
 	virtual bool lt(const LSValue*) const;
+	// Consistent with lt : equivalent values have the same hash
+	virtual size_t hash() const;
 
 	virtual bool in(const LSValue* const) const;
 	virtual bool in_i(const int) const;
@@ -156,6 +167,7 @@ public:
 	static void free(const LSValue*);
 	static void delete_ref(LSValue* value);
 	static void delete_ref2(LSValue* value);
+	static void delete_unowned(LSValue* value);
 	static void delete_temporary(const LSValue* const value);
 	static void delete_not_temporary(LSValue* value);
 };
@@ -198,6 +210,28 @@ inline LSValue* LSValue::move_inc() {
 	return v;
 }
 
+inline void* LSValue::operator new(size_t size) {
+	auto pool = Pool::current;
+	auto total = size + sizeof(Pool*);
+	Pool** block;
+	if (pool and total <= Pool::MAX_SIZE) {
+		block = (Pool**) pool->allocate(total);
+	} else {
+		block = (Pool**) ::operator new(total);
+		pool = nullptr;
+	}
+	*block = pool;
+	return block + 1;
+}
+inline void LSValue::operator delete(void* value, size_t size) {
+	auto block = (Pool**) value - 1;
+	if (*block) {
+		(*block)->free(block, size + sizeof(Pool*));
+	} else {
+		::operator delete(block);
+	}
+}
+
 inline void LSValue::delete_ref(LSValue* value) {
 	if (value->native) return;
 	if (value->refs == 0 || --value->refs == 0) {
@@ -211,6 +245,15 @@ inline void LSValue::delete_ref2(LSValue* value) {
 		delete value;
 	}
 }
+/*
+ * What remains of an elided increment + delete_ref pair : delete the value if nobody owns it
+ */
+inline void LSValue::delete_unowned(LSValue* value) {
+	if (value->native) return;
+	if (value->refs == 0) {
+		delete value;
+	}
+}
 
 inline void LSValue::delete_temporary(const LSValue* const value) {
 	if (value->refs == 0) {
@@ -0,0 +1,38 @@
+#include "Pool.hpp"
+#include <cstdlib>
+
+namespace ls {
+
+thread_local Pool* Pool::current = nullptr;
+
+Pool::~Pool() {
+	for (auto c : chunks) {
+		std::free(c);
+	}
+}
+
+void Pool::release() {
+	released = true;
+	if (live == 0) {
+		delete this;
+	}
+}
+
+void Pool::next_chunk() {
+	if (chunk == chunks.size()) {
+		chunks.push_back((char*) std::aligned_alloc(GRANULARITY, CHUNK_SIZE));
+	}
+	current_block = chunks[chunk++];
+	end = current_block + CHUNK_SIZE;
+}
+
+void Pool::reset() {
+	for (auto& l : free_lists) {
+		l = nullptr;
+	}
+	chunk = 0;
+	current_block = nullptr;
+	end = nullptr;
+}
+
+}
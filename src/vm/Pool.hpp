@@ -0,0 +1,77 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace ls {
+
+/*
+ * Size-classed allocator of the values created during an execution.
+ * Blocks are carved from big chunks and recycled through a free list per size class (16 bytes steps).
+ * When no block is used anymore at the end of an execution, the pool is reset at once :
+ * the free lists are dropped and the chunks are reused from the beginning.
+ * The values remember their pool and keep it alive : when its owner releases it, the pool is freed at once if
+ * it is empty, else with its last block (values exported to a context, kept by the caller...).
+ */
+class Pool {
+public:
+	static const size_t GRANULARITY = 16;
+	static const size_t MAX_SIZE = 256; // Bigger blocks go to the heap
+	static const size_t CHUNK_SIZE = 256 * 1024;
+	static const size_t CLASSES = MAX_SIZE / GRANULARITY;
+
+	// Pool of the execution running on this thread, nullptr outside of the executions
+	static thread_local Pool* current;
+
+	size_t live = 0; // Blocks in use
+
+	Pool() {}
+	Pool(const Pool&) = delete;
+
+	void release();
+
+	void* allocate(size_t size) {
+		auto c = (size - 1) / GRANULARITY;
+		live++;
+		if (auto block = free_lists[c]) {
+			free_lists[c] = block->next;
+			return block;
+		}
+		auto rounded = (c + 1) * GRANULARITY;
+		if ((size_t) (end - current_block) < rounded) {
+			next_chunk();
+		}
+		auto block = current_block;
+		current_block += rounded;
+		return block;
+	}
+	void free(void* pointer, size_t size) {
+		auto c = (size - 1) / GRANULARITY;
+		auto block = (free_block*) pointer;
+		block->next = free_lists[c];
+		free_lists[c] = block;
+		if (--live == 0 and released) {
+			delete this;
+		}
+	}
+	void reset();
+
+private:
+	struct free_block {
+		free_block* next;
+	};
+	free_block* free_lists[CLASSES] = {};
+	std::vector<char*> chunks;
+	size_t chunk = 0; // Index of the chunk after the current one
+	char* current_block = nullptr;
+	char* end = nullptr;
+	bool released = false; // No owner anymore, only the blocks still in use
+
+	~Pool();
+	void next_chunk();
+};
+
+}
+
+#endif
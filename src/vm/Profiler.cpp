@@ -0,0 +1,209 @@
+#include "Profiler.hpp"
+#include <map>
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <pthread.h>
+#include <ucontext.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+
+namespace ls {
+
+// Profiler of the thread : the timer signal is delivered to the profiled thread only
+static thread_local Profiler* active_profiler = nullptr;
+static std::once_flag handler_installed;
+
+void Profiler::add_function(const std::string& name, uint64_t start, uint64_t size) {
+	function f { start, size, name };
+	auto i = std::lower_bound(functions.begin(), functions.end(), f, [](const function& a, const function& b) {
+		return a.start < b.start;
+	});
+	functions.insert(i, f);
+}
+
+void Profiler::remove_functions(uint64_t start, uint64_t end) {
+	functions.erase(std::remove_if(functions.begin(), functions.end(), [&](const function& f) {
+		return f.start >= start and f.start < end;
+	}), functions.end());
+}
+
+const Profiler::function* Profiler::find_function(uint64_t pc) const {
+	auto i = std::upper_bound(functions.begin(), functions.end(), pc, [](uint64_t pc, const function& f) {
+		return pc < f.start;
+	});
+	if (i == functions.begin()) return nullptr;
+	--i;
+	return pc < i->start + i->size ? &*i : nullptr;
+}
+
+/*
+ * Signal handler : no allocation, only writes in the preallocated samples
+ */
+void Profiler::handler(int, siginfo_t*, void* context) {
+	auto profiler = active_profiler;
+	if (!profiler) return;
+	auto index = profiler->sample_count.fetch_add(1);
+	if (index >= profiler->samples.size()) return;
+	auto& s = profiler->samples[index];
+	s.line = profiler->line;
+	s.depth = 0;
+	#if defined(__x86_64__) && defined(__linux__)
+		auto uc = (ucontext_t*) context;
+		uint64_t fp = uc->uc_mcontext.gregs[REG_RBP];
+		s.pcs[s.depth++] = uc->uc_mcontext.gregs[REG_RIP];
+		// Follow the frame pointers while they stay in the stack of the profiled thread
+		while (s.depth < MAX_DEPTH and fp % 8 == 0 and fp >= profiler->stack_low and fp + 16 <= profiler->stack_high) {
+			auto frame = (uint64_t*) fp;
+			if (!frame[1]) break;
+			s.pcs[s.depth++] = frame[1] - 1; // Return address : the call instruction is just before
+			if (frame[0] <= fp) break;
+			fp = frame[0];
+		}
+	#endif
+}
+
+void Profiler::start() {
+	samples.resize(MAX_SAMPLES);
+	sample_count = 0;
+	line = 0;
+
+	pthread_attr_t attr;
+	void* stack_addr;
+	size_t stack_size;
+	pthread_getattr_np(pthread_self(), &attr);
+	pthread_attr_getstack(&attr, &stack_addr, &stack_size);
+	pthread_attr_destroy(&attr);
+	stack_low = (uint64_t) stack_addr;
+	stack_high = stack_low + stack_size;
+
+	// Installed once for the process, it ignores the threads without a profiler
+	std::call_once(handler_installed, []() {
+		struct sigaction action;
+		action.sa_sigaction = handler;
+		action.sa_flags = SA_SIGINFO | SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGPROF, &action, nullptr);
+	});
+	active_profiler = this;
+
+	// CPU time of this thread, signaled to this thread : the other environments running on other threads are not sampled
+	sigevent event {};
+	event.sigev_notify = SIGEV_THREAD_ID;
+	event.sigev_signo = SIGPROF;
+	event._sigev_un._tid = syscall(SYS_gettid);
+	if (timer_create(CLOCK_THREAD_CPUTIME_ID, &event, &timer)) {
+		active_profiler = nullptr;
+		return;
+	}
+	itimerspec interval;
+	interval.it_interval.tv_sec = 0;
+	interval.it_interval.tv_nsec = 1000000000 / frequency;
+	interval.it_value = interval.it_interval;
+	timer_settime(timer, 0, &interval, nullptr);
+	timer_running = true;
+}
+
+void Profiler::stop() {
+	if (timer_running) {
+		timer_delete(timer);
+		timer_running = false;
+	}
+	active_profiler = nullptr;
+}
+
+static std::string native_function_name(uint64_t pc) {
+	Dl_info info;
+	if (!dladdr((void*) pc, &info) or !info.dli_sname) {
+		return "[native]";
+	}
+	int status;
+	auto demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+	std::string name = status == 0 ? demangled : info.dli_sname;
+	free(demangled);
+	// Arguments types are long and useless in a flame graph
+	auto p = name.find('(');
+	return p != std::string::npos ? name.substr(0, p) : name;
+}
+
+std::vector<Profiler::stack> Profiler::symbolize() const {
+	std::map<std::vector<std::string>, std::pair<std::string, size_t>> stacks;
+	auto count = std::min(sample_count.load(), samples.size());
+	for (size_t i = 0; i < count; ++i) {
+		const auto& s = samples[i];
+		// Keep the frames above the outermost LeekScript function (the VM and the CLI are not interesting)
+		int outermost = -1, innermost = -1;
+		for (int d = 0; d < s.depth; ++d) {
+			if (find_function(s.pcs[d])) {
+				if (innermost == -1) innermost = d;
+				outermost = d;
+			}
+		}
+		std::vector<std::string> frames;
+		std::string line = "[unknown]";
+		if (outermost == -1) {
+			frames.push_back("[unknown]");
+		} else {
+			for (int d = outermost; d >= 0; --d) {
+				auto f = find_function(s.pcs[d]);
+				auto name = f ? f->name : native_function_name(s.pcs[d]);
+				// The line is the last one stored by the compiled code, it belongs to the innermost LeekScript function
+				if (d == innermost) {
+					name += ":" + std::to_string(s.line);
+					line = name;
+				}
+				if (frames.size() and frames.back() == name and name == "[native]") continue;
+				frames.push_back(name);
+			}
+		}
+		auto& stack = stacks[frames];
+		stack.first = line;
+		stack.second++;
+	}
+	std::vector<stack> result;
+	for (const auto& s : stacks) {
+		result.push_back({ s.first, s.second.first, s.second.second });
+	}
+	return result;
+}
+
+void Profiler::write_folded(std::ostream& os) const {
+	for (const auto& stack : symbolize()) {
+		for (size_t i = 0; i < stack.frames.size(); ++i) {
+			if (i) os << ";";
+			os << stack.frames[i];
+		}
+		os << " " << stack.count << std::endl;
+	}
+}
+
+void Profiler::write_report(std::ostream& os, size_t count) const {
+	auto stacks = symbolize();
+	size_t total = 0;
+	std::map<std::string, size_t> functions_self;
+	std::map<std::string, size_t> lines;
+	for (const auto& stack : stacks) {
+		total += stack.count;
+		functions_self[stack.frames.back()] += stack.count;
+		lines[stack.line] += stack.count;
+	}
+	auto print = [&](const std::string& title, const std::map<std::string, size_t>& counts) {
+		std::vector<std::pair<std::string, size_t>> sorted(counts.begin(), counts.end());
+		std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b) {
+			return a.second > b.second;
+		});
+		os << "  Samples      %  " << title << std::endl;
+		for (size_t i = 0; i < std::min(count, sorted.size()); ++i) {
+			os << std::setw(9) << sorted[i].second << "  " << std::setw(5) << std::fixed << std::setprecision(1) << (100.0 * sorted[i].second / total) << "  " << sorted[i].first << std::endl;
+		}
+	};
+	os << "Profile: " << total << " samples (" << (1000.0 / frequency) << " ms)" << std::endl;
+	if (!total) return;
+	print("Function (self)", functions_self);
+	print("Line", lines);
+}
+
+}
@@ -0,0 +1,73 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <ostream>
+#include <signal.h>
+#include <time.h>
+
+namespace ls {
+
+/*
+ * Sampling profiler for the JIT-compiled functions.
+ * A SIGPROF timer on the CPU time of the executing thread records the native stack (frame pointers) and the last
+ * line marked by the compiled code, the addresses are symbolized after the execution with the functions registered
+ * by the compiler. Programs running on other threads are not sampled.
+ */
+class Profiler {
+public:
+	static const int MAX_DEPTH = 64;
+	static const size_t MAX_SAMPLES = 20000; // 20 seconds at 1000 Hz, the following samples are dropped
+
+	struct function {
+		uint64_t start;
+		uint64_t size;
+		std::string name;
+	};
+	struct sample {
+		int line;
+		int depth;
+		uint64_t pcs[MAX_DEPTH];
+	};
+
+	bool enabled = false;
+	int frequency = 1000; // Samples per second
+	volatile int line = 0; // Current line, stored by the compiled code
+	std::vector<function> functions;
+	std::vector<sample> samples;
+	std::atomic<size_t> sample_count { 0 };
+	uint64_t stack_low = 0;
+	uint64_t stack_high = 0;
+
+	void add_function(const std::string& name, uint64_t start, uint64_t size);
+	void remove_functions(uint64_t start, uint64_t end);
+	void start();
+	void stop();
+
+	/*
+	 * Folded stacks ("main;f;g:12 42"), input of flamegraph.pl and speedscope
+	 */
+	void write_folded(std::ostream& os) const;
+	/*
+	 * Hottest functions and lines (self samples)
+	 */
+	void write_report(std::ostream& os, size_t count = 10) const;
+
+private:
+	struct stack {
+		std::vector<std::string> frames; // Outermost first
+		std::string line; // Innermost LeekScript function and line
+		size_t count;
+	};
+	static void handler(int, siginfo_t*, void* context);
+	std::vector<stack> symbolize() const;
+	const function* find_function(uint64_t pc) const;
+	timer_t timer;
+	bool timer_running = false;
+};
+
+}
+
+#endif
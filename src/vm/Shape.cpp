@@ -0,0 +1,48 @@
+#include "Shape.hpp"
+
+namespace ls {
+
+std::mutex Shape::transitions_mutex;
+size_t Shape::shared_shapes = 0;
+
+Shape* Shape::empty() {
+	static Shape* empty = new Shape();
+	return empty;
+}
+
+Shape* Shape::add(const std::string& name) {
+	if (not shared) {
+		fields.emplace(name, ShapeField { this, (int) fields.size() });
+		return this;
+	}
+	// The shapes are shared by the VMs of all the threads
+	std::lock_guard<std::mutex> lock(transitions_mutex);
+	auto i = transitions.find(name);
+	if (i != transitions.end()) {
+		return i->second;
+	}
+	auto shape = new Shape();
+	shape->shared = fields.size() < MAX_SHARED_FIELDS and shared_shapes < MAX_SHARED_SHAPES;
+	shape->fields = fields;
+	shape->fields.emplace(name, ShapeField { shape, (int) fields.size() });
+	for (auto& f : shape->fields) {
+		f.second.shape = shape;
+	}
+	if (shape->shared) {
+		transitions.emplace(name, shape);
+		shared_shapes++;
+	}
+	return shape;
+}
+
+Shape* Shape::copy() const {
+	auto shape = new Shape();
+	shape->shared = false;
+	shape->fields = fields;
+	for (auto& f : shape->fields) {
+		f.second.shape = shape;
+	}
+	return shape;
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef SHAPE_HPP
+#define SHAPE_HPP
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+
+namespace ls {
+
+class Shape;
+
+/*
+ * A field of a shape, the entry kept by the inline caches of the compiled field accesses
+ */
+struct ShapeField {
+	const Shape* shape;
+	int slot;
+};
+
+/*
+ * Hidden class of the objects : the names of the fields and their slot in LSObject::slots.
+ * Objects getting the same fields in the same order share the same shape, through the transitions.
+ * Shared shapes are immutable and never freed, the compiled code keeps pointers to their fields.
+ * Past MAX_SHARED_FIELDS fields (objects used as dictionaries), an object gets its own unshared shape.
+ * The shared shapes are capped to MAX_SHARED_SHAPES for a long running process (--server) :
+ * past it, the new shapes are unshared and freed with their object.
+ */
+class Shape {
+public:
+	static const size_t MAX_SHARED_FIELDS = 64;
+	static const size_t MAX_SHARED_SHAPES = 65536;
+
+	std::map<std::string, ShapeField> fields; // In the order of the names, for the iteration
+	bool shared = true;
+
+	// Shape of the objects without fields
+	static Shape* empty();
+
+	const ShapeField* find(const std::string& name) const {
+		auto i = fields.find(name);
+		return i == fields.end() ? nullptr : &i->second;
+	}
+	size_t size() const { return fields.size(); }
+
+	/*
+	 * Shape with a new field : the shared transition, or this shape itself if unshared
+	 */
+	Shape* add(const std::string& name);
+	/*
+	 * Copy of an unshared shape, for a cloned object
+	 */
+	Shape* copy() const;
+
+private:
+	std::unordered_map<std::string, Shape*> transitions;
+	static std::mutex transitions_mutex;
+	static size_t shared_shapes;
+
+	Shape() {}
+	Shape(const Shape&) = delete;
+};
+
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include "StringTable.hpp"
+#include <cassert>
+#include "Pool.hpp"
+#include "value/LSString.hpp"
+
+namespace ls {
+
+thread_local StringTable* StringTable::current = nullptr;
+
+StringTable::~StringTable() {
+	for (const auto& s : strings) {
+		delete s.second;
+	}
+	for (auto c : chars) {
+		delete c;
+	}
+}
+
+LSString* StringTable::create(const std::string& value) {
+	// Out of the pool of the execution
+	auto pool = Pool::current;
+	Pool::current = nullptr;
+	auto s = new LSString(value, true);
+	Pool::current = pool;
+	return s;
+}
+
+LSString* StringTable::get(const std::string& value) {
+	if (value.size() == 1 and value[0] >= 0) {
+		return get(value[0]);
+	}
+	auto i = strings.find(value);
+	if (i != strings.end()) {
+		return i->second;
+	}
+	auto size = sizeof(LSString) + 2 * value.size();
+	if (bytes + size > MAX_BYTES) {
+		return nullptr;
+	}
+	bytes += size;
+	auto s = create(value);
+	strings.emplace(value, s);
+	return s;
+}
+
+LSString* StringTable::get(char c) {
+	assert(c >= 0);
+	auto& s = chars[(int) c];
+	if (!s) {
+		s = create(std::string(1, c));
+	}
+	return s;
+}
+
+LSString* StringTable::character(char c) {
+	if (current and c >= 0) {
+		return current->get(c);
+	}
+	return new LSString(c);
+}
+
+}
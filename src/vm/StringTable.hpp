@@ -0,0 +1,47 @@
+#ifndef STRING_TABLE_HPP
+#define STRING_TABLE_HPP
+
+#include <string>
+#include <unordered_map>
+
+namespace ls {
+
+class LSString;
+
+/*
+ * Interned strings of a VM : the string literals of the programs and the one-character ASCII strings.
+ * They are native values shared by all their users, equal strings are the same object :
+ * comparisons and map keys get a pointer equality fast path and the literals don't allocate.
+ * Like the shared numbers, they are copied before being modified in place (LSString::unshare).
+ * The VM must outlive the values it created.
+ * The literals are never freed, the compiled programs keep them : the table stops growing at
+ * MAX_BYTES (a --server process), the literals of the next programs allocate a string again.
+ */
+class StringTable {
+public:
+	// Table of the execution running on this thread, nullptr outside of the executions
+	static thread_local StringTable* current;
+
+	StringTable() {}
+	StringTable(const StringTable&) = delete;
+	~StringTable();
+
+	static const size_t MAX_BYTES = 4 << 20;
+
+	LSString* get(const std::string& value); // nullptr if the table is full
+	LSString* get(char c); // ASCII character
+
+	// One-character string, interned if an execution is running
+	static LSString* character(char c);
+
+private:
+	std::unordered_map<std::string, LSString*> strings;
+	LSString* chars[128] = {};
+	size_t bytes = 0;
+
+	LSString* create(const std::string& value);
+};
+
+}
+
+#endif
@@ -13,6 +13,8 @@
 #include "../analyzer/Program.hpp"
 #include "value/LSObject.hpp"
 #include "value/LSFunction.hpp"
+#include "value/LSNull.hpp"
+#include "value/LSBoolean.hpp"
 #include "../standard/class/ValueSTD.hpp"
 #include "../standard/class/NullSTD.hpp"
 #include "../standard/class/NumberSTD.hpp"
@@ -41,7 +43,9 @@ VM::VM(Environment& env, StandardLibrary& std) : env(env), std(std) {
 	operation_limit = VM::DEFAULT_OPERATION_LIMIT;
 }
 
-VM::~VM() {}
+VM::~VM() {
+	pool->release();
+}
 
 void VM::static_init() {
 	// Global initialization
@@ -64,11 +68,14 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 	VM::mpz_deleted = 0;
 	VM::operations = 0;
 	VM::enable_operations = ops;
-	Type::placeholder_counter = 0;
 	#if DEBUG_LEAKS
 		LSValue::objs().clear();
 	#endif
 	this->context = program.context;
+	auto previous_pool = Pool::current;
+	Pool::current = pool;
+	auto previous_strings = StringTable::current;
+	StringTable::current = &strings;
 
 	if (pseudo_code) {
 		if (debug) std::cout << std::endl;
@@ -83,6 +90,7 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 	if (program.result.compilation_success) {
 		std::string value = "";
 		auto exe_start = std::chrono::high_resolution_clock::now();
+		if (profiler.enabled) profiler.start();
 		try {
 			value = program.execute(*this);
 			program.result.execution_success = true;
@@ -90,6 +98,12 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 			// std::cout << "Exception caught \t" << (void*) &ex << std::endl;
 			program.result.exception = ex;
 		}
+		if (profiler.enabled) {
+			profiler.stop();
+			std::ostringstream report;
+			profiler.write_report(report);
+			program.result.profile = report.str();
+		}
 		auto exe_end = std::chrono::high_resolution_clock::now();
 
 		auto execution_time = std::chrono::duration_cast<std::chrono::nanoseconds>(exe_end - exe_start).count();
@@ -113,6 +127,13 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 	VM::enable_operations = true;
 	env.clear_placeholder_types();
 
+	// All the values of the execution are gone (none exported to the context) : drop the pool at once
+	Pool::current = previous_pool;
+	StringTable::current = previous_strings;
+	if (pool->live == 0) {
+		pool->reset();
+	}
+
 	// Results
 	program.result.objects_created = LSValue::obj_count;
 	program.result.objects_deleted = LSValue::obj_deleted;
@@ -143,51 +164,25 @@ void VM::execute(Program& program, bool format, bool debug, bool ops, bool assem
 #if COMPILER
 void* VM::resolve_symbol(std::string name) {
 	// std::cout << "VM::resolve_symbol " << name << std::endl;
-	const auto& p = name.find(".");
-	if (p != std::string::npos) {
-		const auto& module = name.substr(0, p);
-		// std::cout << "module = " << module << std::endl;
-		auto method = name.substr(p + 1);
-		const auto& h = method.find(".");
-		int version = 0;
-		if (h != std::string::npos) {
-			version = std::stoi(method.substr(h + 1));
-			method = method.substr(0, h);
-		}
-		// std::cout << "method = " << method << std::endl;
-		// std::cout << "version = " << version << std::endl;
-		if (module == "ctx") {
-			return &context->vars.at(method).value;
-		} else if (std.classes.find(module) != std.classes.end()) {
-			const auto& clazz = std.classes.at(module)->clazz;
-			if (method.substr(0, 8) == "operator") {
-				const auto& op = method.substr(8);
-				if (clazz->operators.find(op) != clazz->operators.end()) {
-					const auto& implems = clazz->operators.at(op);
-					return implems.versions.at(version).addr;
-				}
-				std::cout << C_YELLOW << "Operator '" << name << "' not found!" << END_COLOR << std::endl;
-			} else {
-				if (clazz->methods.find(method) != clazz->methods.end()) {
-					const auto& implems = clazz->methods.at(method);
-					return implems.versions.at(version).addr;
-				} else if (clazz->static_fields.find(method) != clazz->static_fields.end()) {
-					if (clazz->static_fields.at(method).native_fun) {
-						return clazz->static_fields.at(method).native_fun;
-					} else {
-						return clazz->static_fields.at(method).addr;
-					}
-				} else if (clazz->fields.find(method) != clazz->fields.end()) {
-					return clazz->fields.at(method).native_fun;
-				}
-				std::cout << C_YELLOW << "Method '" << name << "' not found!" << END_COLOR << std::endl;
-			}
-		}
-	} else {
-		if (std.classes.find(name) != std.classes.end()) {
-			return std.classes.at(name)->lsclass;
-		}
+	// Standard library functions, fields and classes : precomputed table
+	if (auto s = std.symbol(name)) {
+		return s;
+	}
+	// Context variables and VM values
+	if (name.compare(0, 4, "ctx.") == 0) {
+		if (not context) return nullptr;
+		const auto& var = context->vars.find(name.substr(4));
+		return var != context->vars.end() ? &var->second.value : nullptr;
 	}
+	if (name == "vm") return this;
+	if (name == "null") return LSNull::get();
+	if (name == "true") return LSBoolean::get(true);
+	if (name == "false") return LSBoolean::get(false);
+	if (name == "mpzc") return &mpz_created;
+	if (name == "mpzd") return &mpz_deleted;
+	if (name == "operations") return &operations;
+	if (name == "profile_line") return (void*) &profiler.line;
+	if (name == "exception_typeinfo") return (void*) &typeid(vm::ExceptionObj);
 	return nullptr;
 }
 #endif
@@ -14,6 +14,9 @@
 #include "../compiler/Compiler.hpp"
 #include "Exception.hpp"
 #include "OutputStream.hpp"
+#include "Profiler.hpp"
+#include "Pool.hpp"
+#include "StringTable.hpp"
 #include "../analyzer/semantic/Call.hpp"
 
 #define OPERATION_LIMIT 10000000
@@ -44,6 +47,8 @@ public:
 
 	Environment& env;
 	StandardLibrary& std;
+	Pool* pool = new Pool(); // Values created by the executions, released by the VM, freed with the last of them
+	StringTable strings; // Interned strings, shared by the executions
 	std::vector<std::unique_ptr<Module>> modules;
 	std::vector<LSValue*> function_created;
 	std::vector<Class*> class_created;
@@ -57,6 +62,7 @@ public:
 	std::string file_name;
 	bool legacy;
 	Context* context = nullptr;
+	Profiler profiler;
 
 	VM(Environment& env, StandardLibrary& std);
 	~VM();
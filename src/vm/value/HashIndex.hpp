@@ -0,0 +1,136 @@
+#ifndef LS_HASH_INDEX
+#define LS_HASH_INDEX
+
+#include <vector>
+#include <cstring>
+#include "../LSValue.hpp"
+
+namespace ls {
+
+/*
+ * Hash of the keys, consistent with the tree equivalence (!(a < b) && !(b < a)).
+ * The index takes the high bits of the hash multiplied by 2^64 / phi (Fibonacci hashing) : all the bits of the
+ * key count, the keys differing only by their high bits (powers of 2) don't collide.
+ */
+inline size_t lshash(int key) {
+	return (size_t) key;
+}
+inline size_t lshash(double key) {
+	if (key == 0) key = 0; // -0.0 and 0.0 are the same key
+	uint64_t bits;
+	std::memcpy(&bits, &key, sizeof(bits));
+	return bits;
+}
+inline size_t lshash(const LSValue* key) {
+	return key->hash();
+}
+inline bool lshash_equals(int a, int b) { return a == b; }
+inline bool lshash_equals(double a, double b) { return a == b; }
+inline bool lshash_equals(const LSValue* a, const LSValue* b) {
+	return a == b or (!(*a < *b) and !(*b < *a));
+}
+
+/*
+ * Open-addressing (linear probing) index of the nodes of a LSMap or a LSSet.
+ * The tree keeps the order (iteration, printing, comparisons), the index gives O(1) lookups.
+ * It is built on the first lookup of a big enough container, then maintained by the insertions and removals.
+ */
+template <class K, class It, class KeyOf>
+class HashIndex {
+	std::vector<It> slots; // Power of 2 size, It() is an empty slot
+	size_t count = 0;
+	unsigned shift = 0; // 64 - log2(slots.size())
+
+	size_t slot(const K& key) const {
+		return (lshash(key) * 0x9E3779B97F4A7C15ul) >> shift;
+	}
+
+public:
+	static const size_t MIN_SIZE = 16; // Below, the tree is as fast
+	bool valid = false;
+
+	void clear() {
+		slots.clear();
+		count = 0;
+		valid = false;
+	}
+
+	template <class C>
+	void build(C& container) {
+		clear();
+		valid = true;
+		resize(container.size());
+		for (auto it = container.begin(); it != container.end(); ++it) {
+			insert_slot(it);
+		}
+	}
+
+	bool find(const K& key, It& result) const {
+		auto mask = slots.size() - 1;
+		for (auto i = slot(key);; i = (i + 1) & mask) {
+			if (slots[i] == It()) return false;
+			if (lshash_equals(KeyOf()(slots[i]), key)) {
+				result = slots[i];
+				return true;
+			}
+		}
+	}
+
+	void add(It it) {
+		if (!valid) return;
+		if ((count + 1) * 4 > slots.size() * 3) {
+			resize(count + 1);
+		}
+		insert_slot(it);
+	}
+
+	void remove(It it) {
+		if (!valid) return;
+		auto mask = slots.size() - 1;
+		auto i = slot(KeyOf()(it));
+		while (slots[i] != it) {
+			i = (i + 1) & mask;
+		}
+		// Backward shift : move back the following entries which are not at their best place
+		for (auto j = (i + 1) & mask; slots[j] != It(); j = (j + 1) & mask) {
+			auto h = slot(KeyOf()(slots[j]));
+			bool movable = i <= j ? (h <= i or h > j) : (h <= i and h > j);
+			if (movable) {
+				slots[i] = slots[j];
+				i = j;
+			}
+		}
+		slots[i] = It();
+		count--;
+	}
+
+private:
+	void resize(size_t size) {
+		size_t capacity = 16;
+		shift = sizeof(size_t) * 8 - 4;
+		while (capacity < size * 2) {
+			capacity *= 2;
+			shift--;
+		}
+		std::vector<It> old;
+		old.swap(slots);
+		slots.resize(capacity);
+		count = 0;
+		for (const auto& it : old) {
+			if (it != It()) insert_slot(it);
+		}
+	}
+	void insert_slot(It it) {
+		auto mask = slots.size() - 1;
+		auto i = slot(KeyOf()(it));
+		while (slots[i] != It()) {
+			i = (i + 1) & mask;
+		}
+		slots[i] = it;
+		count++;
+	}
+};
+
+}
+
+#endif
@@ -15,6 +15,8 @@ class LSArray : public LSValue, public std::vector<T> {
 public:
 
 	static LSArray<T>* constructor(int);
+	static LSArray<T>* stack_constructor(void* memory, int capacity);
+	static void stack_destructor(LSArray<T>* array);
 
 	LSArray();
 	LSArray(std::initializer_list<T>);
@@ -102,6 +104,7 @@ public:
 	LSValue* add_eq_int(int v);
 	bool eq(const LSValue*) const override;
 	bool lt(const LSValue*) const override;
+	size_t hash() const override;
 
 	virtual bool in(const LSValue* const) const override;
 	virtual bool in_i(const int) const override;
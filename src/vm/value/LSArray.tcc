@@ -21,6 +21,23 @@ LSArray<T>* LSArray<T>::constructor(int capacity) {
 	return array;
 }
 
+/*
+ * Temporary container built in the stack of the compiled code. Its refs are shared (like the shared numbers) :
+ * the runtime never frees it nor reuses it as a temporary, and copies it if it's stored.
+ * The compiled code destroys it in place at the end of its block.
+ */
+template <class T>
+LSArray<T>* LSArray<T>::stack_constructor(void* memory, int capacity) {
+	auto array = new (memory) LSArray<T>();
+	array->refs = 1 << 30;
+	array->reserve(capacity);
+	return array;
+}
+template <class T>
+void LSArray<T>::stack_destructor(LSArray<T>* array) {
+	array->~LSArray<T>();
+}
+
 template <>
 inline LSArray<LSValue*>::~LSArray() {
 	for (auto v : *this) {
@@ -1501,6 +1518,27 @@ inline bool LSArray<LSValue*>::lt(const LSValue* v) const {
 	return LSValue::lt(v);
 }
 
+/*
+ * Consistent with lt : a number element hashes like a LSNumber, whatever the type of the array
+ */
+template <class T>
+inline size_t LSArray<T>::hash() const {
+	size_t h = type;
+	for (const auto& v : *this) {
+		h = h * 31 + std::hash<double>()(v == 0 ? 0.0 : (double) v);
+	}
+	return h;
+}
+
+template <>
+inline size_t LSArray<LSValue*>::hash() const {
+	size_t h = type;
+	for (const auto& v : *this) {
+		h = h * 31 + v->hash();
+	}
+	return h;
+}
+
 template <typename T>
 inline bool LSArray<T>::in(const LSValue* const value) const {
 	if (value->type != LSValue::NUMBER) {
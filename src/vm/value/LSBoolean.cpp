@@ -8,8 +8,8 @@
 
 namespace ls {
 
-LSBoolean* LSBoolean::false_val;
-LSBoolean* LSBoolean::true_val;
+thread_local LSBoolean* LSBoolean::false_val = nullptr;
+thread_local LSBoolean* LSBoolean::true_val = nullptr;
 
 LSBoolean::LSBoolean(bool value) : LSValue(BOOLEAN, 1, true), value(value) {}
 
@@ -112,6 +112,10 @@ int LSBoolean::abso() const {
 	return value;
 }
 
+size_t LSBoolean::hash() const {
+	return type + value;
+}
+
 LSValue* LSBoolean::clone() const {
 	return (LSValue*) this;
 }
@@ -15,12 +15,20 @@ public:
 
 	const bool value;
 
-	static LSBoolean* false_val;
-	static LSBoolean* true_val;
+	// One pair of booleans per thread, like LSNull
+	static thread_local LSBoolean* false_val;
+	static thread_local LSBoolean* true_val;
 	static LSBoolean* create(bool value) {
 		return new LSBoolean(value);
 	}
 	static LSBoolean* get(bool value) {
+		if (!true_val) {
+			auto pool = Pool::current;
+			Pool::current = nullptr;
+			true_val = create(true);
+			false_val = create(false);
+			Pool::current = pool;
+		}
 		return value ? true_val : false_val;
 	}
 	static void set_true_value(LSBoolean* v) {
@@ -45,6 +53,7 @@ public:
 	bool operator < (double value) const override;
 
 	int abso() const override;
+	size_t hash() const override;
 
 	LSValue* clone() const override;
 
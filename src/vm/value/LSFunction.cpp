@@ -48,6 +48,10 @@ bool LSFunction::lt(const LSValue* v) const {
 	return LSValue::lt(v);
 }
 
+size_t LSFunction::hash() const {
+	return std::hash<void*>()(function);
+}
+
 LSValue* LSFunction::attr(VM* vm, const std::string& key) const {
 	if (key == "args") {
 		LSArray<LSValue*>* args_list = new LSArray<LSValue*>();
@@ -38,6 +38,7 @@ public:
 	bool ls_not() const override;
 	bool eq(const LSValue*) const override;
 	bool lt(const LSValue*) const override;
+	size_t hash() const override;
 	LSValue* attr(VM* vm, const std::string& key) const override;
 	LSValue* clone() const override;
 	std::ostream& dump(std::ostream& os, int level) const override;
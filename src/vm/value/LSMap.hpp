@@ -2,6 +2,7 @@
 #define LS_MAP_BASE
 
 #include "../LSValue.hpp"
+#include "HashIndex.hpp"
 #include <map>
 
 namespace ls {
@@ -12,11 +13,33 @@ struct lsmap_less {
 };
 
 template <typename K, typename V>
-class LSMap : public LSValue, public std::map<K, V, lsmap_less<K>> {
+class LSMap : public LSValue, protected std::map<K, V, lsmap_less<K>> {
+	typedef std::map<K, V, lsmap_less<K>> base;
+	struct key_of {
+		K operator () (typename base::iterator it) const { return it->first; }
+	};
+	mutable HashIndex<K, typename base::iterator, key_of> index;
+
 public:
+	/*
+	 * The tree is only read from outside, the mutations go through the indexed operations below
+	 */
+	using typename base::iterator;
+	using typename base::const_iterator;
+	using typename base::value_type;
+	using base::begin;
+	using base::end;
+	using base::rbegin;
+	using base::rend;
+	using base::size;
+	using base::empty;
+	using base::lower_bound;
+	using base::upper_bound;
+
 	static LSMap<K, V>* constructor();
 
 	LSMap();
+	LSMap(const LSMap<K, V>& other);
 	virtual ~LSMap();
 
 	/*
@@ -43,6 +66,24 @@ public:
 	static V std_at(const LSMap<K, V>* const map, K key);
 	static bool std_in(const LSMap<K, V>* const map, const LSValue*);
 
+	/*
+	 * Tree operations, also maintaining the hash index
+	 */
+	typename base::iterator find(const K& key);
+	typename base::const_iterator find(const K& key) const;
+	size_t count(const K& key) const;
+	template <class... Args>
+	std::pair<typename base::iterator, bool> emplace(Args&&... args);
+	template <class... Args>
+	typename base::iterator emplace_hint(typename base::const_iterator hint, Args&&... args);
+	std::pair<typename base::iterator, bool> insert(const typename base::value_type& value);
+	typename base::iterator erase(typename base::iterator it);
+	typename base::iterator erase(typename base::iterator first, typename base::iterator last);
+	size_t erase(const K& key);
+	void clear();
+	V& operator [] (const K& key);
+	LSMap<K, V>& operator = (const LSMap<K, V>& other);
+
 	/*
 	 * LSValue methods;
 	 */
@@ -31,7 +31,7 @@ inline bool lsmap_less<K>::operator()(K lhs, K rhs) const {
 
 template <>
 inline bool lsmap_less<LSValue*>::operator()(LSValue* lhs, LSValue* rhs) const {
-	return *lhs < *rhs;
+	return lhs != rhs and *lhs < *rhs;
 }
 
 template <class K, class T>
@@ -42,6 +42,9 @@ LSMap<K, T>* LSMap<K, T>::constructor() {
 template <class K, class T>
 LSMap<K, T>::LSMap() : LSValue(MAP) {}
 
+template <class K, class T>
+LSMap<K, T>::LSMap(const LSMap<K, T>& other) : LSValue(other), std::map<K, T, lsmap_less<K>>(other) {}
+
 template <class K, class V>
 LSMap<K, V>::~LSMap() {
 	for (auto it = this->begin(); it != this->end(); ++it) {
@@ -62,9 +65,8 @@ int LSMap<K, V>::std_size(const LSMap<K, V>* const map) {
 
 template <class K, class V>
 bool LSMap<K, V>::std_insert(LSMap<K, V>* map, K key, V value) {
-	auto it = map->lower_bound(key);
-	if (it == map->end() || !ls::equals(it->first, key)) {
-		map->emplace_hint(it, ls::move_inc(key), ls::move_inc(value));
+	if (map->find(key) == map->end()) {
+		map->emplace(ls::move_inc(key), ls::move_inc(value));
 		if (map->refs == 0) delete map;
 		return true;
 	}
@@ -76,9 +78,8 @@ bool LSMap<K, V>::std_insert(LSMap<K, V>* map, K key, V value) {
 
 template <class K, class V>
 void LSMap<K, V>::std_emplace(LSMap<K, V>* map, K key, V value) {
-	auto it = map->lower_bound(key);
-	if (it == map->end() || !ls::equals(it->first, key)) {
-		map->emplace_hint(it, ls::move_inc(key), ls::move_inc(value));
+	if (map->find(key) == map->end()) {
+		map->emplace(ls::move_inc(key), ls::move_inc(value));
 	} else {
 		ls::release(key);
 		ls::release(value);
@@ -237,6 +238,100 @@ bool LSMap<K, V>::std_in(const LSMap<K, V>* const map, const LSValue* v) {
 	return map->in(v);
 }
 
+/*
+ * Tree operations
+ */
+template <class K, class V>
+typename LSMap<K, V>::base::iterator LSMap<K, V>::find(const K& key) {
+	if (!index.valid) {
+		if (this->size() < decltype(index)::MIN_SIZE) {
+			return base::find(key);
+		}
+		index.build(*this);
+	}
+	typename base::iterator it;
+	return index.find(key, it) ? it : this->end();
+}
+
+template <class K, class V>
+typename LSMap<K, V>::base::const_iterator LSMap<K, V>::find(const K& key) const {
+	return ((LSMap<K, V>*) this)->find(key);
+}
+
+template <class K, class V>
+size_t LSMap<K, V>::count(const K& key) const {
+	return find(key) != this->end();
+}
+
+template <class K, class V>
+template <class... Args>
+std::pair<typename LSMap<K, V>::base::iterator, bool> LSMap<K, V>::emplace(Args&&... args) {
+	auto r = base::emplace(std::forward<Args>(args)...);
+	if (r.second) index.add(r.first);
+	return r;
+}
+
+template <class K, class V>
+template <class... Args>
+typename LSMap<K, V>::base::iterator LSMap<K, V>::emplace_hint(typename base::const_iterator hint, Args&&... args) {
+	auto size = this->size();
+	auto it = base::emplace_hint(hint, std::forward<Args>(args)...);
+	if (this->size() != size) index.add(it);
+	return it;
+}
+
+template <class K, class V>
+std::pair<typename LSMap<K, V>::base::iterator, bool> LSMap<K, V>::insert(const typename base::value_type& value) {
+	auto r = base::insert(value);
+	if (r.second) index.add(r.first);
+	return r;
+}
+
+template <class K, class V>
+typename LSMap<K, V>::base::iterator LSMap<K, V>::erase(typename base::iterator it) {
+	index.remove(it);
+	return base::erase(it);
+}
+
+template <class K, class V>
+typename LSMap<K, V>::base::iterator LSMap<K, V>::erase(typename base::iterator first, typename base::iterator last) {
+	for (auto it = first; it != last; ++it) {
+		index.remove(it);
+	}
+	return base::erase(first, last);
+}
+
+template <class K, class V>
+size_t LSMap<K, V>::erase(const K& key) {
+	auto it = find(key);
+	if (it == this->end()) return 0;
+	erase(it);
+	return 1;
+}
+
+template <class K, class V>
+void LSMap<K, V>::clear() {
+	index.clear();
+	base::clear();
+}
+
+template <class K, class V>
+V& LSMap<K, V>::operator [] (const K& key) {
+	auto it = find(key);
+	if (it != this->end()) return it->second;
+	return emplace(key, V()).first->second;
+}
+
+/*
+ * Copy of the tree only, the index is built again at the next lookup
+ */
+template <class K, class V>
+LSMap<K, V>& LSMap<K, V>::operator = (const LSMap<K, V>& other) {
+	index.clear();
+	base::operator = (other);
+	return *this;
+}
+
 /*
  * LSValue methods
  */
@@ -348,30 +443,20 @@ bool LSMap<K, T>::lt(const LSValue* v) const {
 
 template <class K, class V>
 V LSMap<K, V>::at_k(const K key) const {
-	bool ex = false;
-	try {
-		auto map = (std::map<K, V, lsmap_less<K>>*) this;
-		return map->at(key);
-	} catch (std::exception&) {
-		ex = true;
-	}
-	if (ex)
+	auto it = find(key);
+	if (it == this->end()) {
 		throw vm::ExceptionObj(vm::Exception::ARRAY_OUT_OF_BOUNDS);
-	assert(false); // LCOV_EXCL_LINE
+	}
+	return it->second;
 }
 
 template <class K, class V>
 LSValue* LSMap<K, V>::at(const LSValue* key) const {
-	bool ex = false;
-	try {
-		auto map = (std::map<K, V, lsmap_less<K>>*) this;
-		return ls::convert<LSValue*>(map->at(ls::convert<K>(key)));
-	} catch (std::exception&) {
-		ex = true;
-	}
-	if (ex)
+	auto it = find(ls::convert<K>(key));
+	if (it == this->end()) {
 		throw vm::ExceptionObj(vm::Exception::ARRAY_OUT_OF_BOUNDS);
-	assert(false); // LCOV_EXCL_LINE
+	}
+	return ls::convert<LSValue*>(it->second);
 }
 
 template <typename K, typename T>
@@ -415,16 +500,14 @@ inline LSValue** LSMap<double, LSValue*>::atL(const LSValue* key) {
 template <class K, class T>
 inline T* LSMap<K, T>::atL_base(LSMap<K, T>* raw_map, K key) {
 	// std::cout << "atL_base " << key << std::endl;
-	auto map = (std::map<K, T, lsmap_less<K>>*) raw_map;
-	try {
-		auto r = &map->at(key);
+	auto it = raw_map->find(key);
+	if (it != raw_map->end()) {
 		ls::release(key);
-		return r;
-	} catch (std::exception&) {
-		auto k = ls::move_inc(key);
-		auto r = map->insert({k, ls::construct<T>()});
-		return &r.first->second;
+		return &it->second;
 	}
+	auto k = ls::move_inc(key);
+	auto r = raw_map->insert({k, ls::construct<T>()});
+	return &r.first->second;
 }
 
 template <class K, class V>
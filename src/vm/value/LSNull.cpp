@@ -6,9 +6,16 @@
 
 namespace ls {
 
-LSValue* LSNull::null_var;
+thread_local LSValue* LSNull::null_var = nullptr;
 
 LSValue* LSNull::get() {
+	if (!null_var) {
+		// Immortal : out of the pool of the execution
+		auto pool = Pool::current;
+		Pool::current = nullptr;
+		null_var = create();
+		Pool::current = pool;
+	}
 	return null_var;
 }
 
@@ -9,7 +9,8 @@ namespace ls {
 
 class LSNull : public LSValue {
 private:
-	static LSValue* null_var;
+	// One null per thread, its refs are touched by the generated code
+	static thread_local LSValue* null_var;
 	LSNull();
 
 public:
@@ -12,7 +12,20 @@
 
 namespace ls {
 
+thread_local LSNumber* LSNumber::small_numbers[SMALL_MAX - SMALL_MIN] = {};
+
 LSNumber* LSNumber::get(NUMBER_TYPE i) {
+	if (i >= SMALL_MIN and i < SMALL_MAX and i == (int) i and not (i == 0 and std::signbit(i))) {
+		auto& n = small_numbers[(int) i - SMALL_MIN];
+		if (!n) {
+			// Out of the pool of the execution
+			auto pool = Pool::current;
+			Pool::current = nullptr;
+			n = new LSNumber(i, true);
+			Pool::current = pool;
+		}
+		return n;
+	}
 	return new LSNumber(i);
 }
 
@@ -38,6 +51,8 @@ std::string LSNumber::print(double d) {
 }
 
 LSNumber::LSNumber(NUMBER_TYPE value) : LSValue(NUMBER), value(value) {}
+// The refs of the shared numbers are not balanced (not incremented by move_inc), they must never reach 0
+LSNumber::LSNumber(NUMBER_TYPE value, bool native) : LSValue(NUMBER, 1 << 30, native), value(value) {}
 
 LSNumber::~LSNumber() {}
 
@@ -96,22 +111,26 @@ LSValue* LSNumber::ls_tilde() {
 }
 
 LSValue* LSNumber::ls_preinc() {
+	if (native) return LSNumber::get(value + 1);
 	value += 1;
 	return this;
 }
 
 LSValue* LSNumber::ls_inc() {
+	if (native) return this;
 	LSValue* r = LSNumber::get(value);
 	value += 1;
 	return r;
 }
 
 LSValue* LSNumber::ls_predec() {
+	if (native) return LSNumber::get(value - 1);
 	value -= 1;
 	return this;
 }
 
 LSValue* LSNumber::ls_dec() {
+	if (native) return this;
 	LSValue* r = LSNumber::get(value);
 	value -= 1;
 	return r;
@@ -549,6 +568,10 @@ int LSNumber::abso() const {
 	return abs((int) value);
 }
 
+size_t LSNumber::hash() const {
+	return std::hash<double>()(value == 0 ? 0.0 : value);
+}
+
 LSValue* LSNumber::clone() const {
 	return LSNumber::get(this->value);
 }
@@ -14,10 +14,23 @@ class LSClass;
 class LSNumber : public LSValue {
 public:
 
+	// Small integers are shared and immortal (like null and the booleans) : no allocation when they go in an any
+	static const int SMALL_MIN = -128;
+	static const int SMALL_MAX = 1024;
+	static thread_local LSNumber* small_numbers[SMALL_MAX - SMALL_MIN];
+
 	NUMBER_TYPE value;
 
 	static LSNumber* get(NUMBER_TYPE);
 	static std::string print(double);
+	// Replace a shared number by its own copy before modifying it in place
+	static void unshare(LSValue** x) {
+		if ((*x)->native and (*x)->type == NUMBER) {
+			auto copy = new LSNumber(static_cast<LSNumber*>(*x)->value);
+			copy->refs = 1;
+			*x = copy;
+		}
+	}
 
 	LSNumber(NUMBER_TYPE value);
 
@@ -67,9 +80,13 @@ public:
 	bool operator < (double value) const override;
 
 	int abso() const override;
+	size_t hash() const override;
 
 	LSValue* clone() const override;
 
+private:
+	LSNumber(NUMBER_TYPE value, bool native);
+
 	std::ostream& dump(std::ostream& os, int level) const override;
 	std::string json() const override;
 	std::string toString() const;
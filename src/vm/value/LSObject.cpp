@@ -12,6 +12,7 @@ LSObject* LSObject::constructor() {
 }
 
 LSObject::LSObject() : LSValue(OBJECT) {
+	shape = Shape::empty();
 	clazz = nullptr;
 	readonly = false;
 }
@@ -24,13 +25,26 @@ LSObject::LSObject(LSClass* clazz) : LSObject() {
 }
 
 LSObject::~LSObject() {
-	for (auto v : values) {
-		LSValue::delete_ref(v.second);
+	clear();
+}
+
+void LSObject::clear() {
+	for (auto v : slots) {
+		// A field taken by attr() on a temporary object
+		if (v) LSValue::delete_ref(v);
 	}
+	slots.clear();
+	if (not shape->shared) delete shape;
+	shape = Shape::empty();
 }
 
 void LSObject::addField(const char* name, LSValue* var) {
-	values.insert({name, var->move_inc()});
+	if (shape->find(name)) {
+		LSValue::delete_temporary(var);
+		return;
+	}
+	shape = shape->add(name);
+	slots.push_back(var->move_inc());
 }
 
 void LSObject::std_add_field(LSObject* object, const char* name, LSValue* var) {
@@ -38,13 +52,15 @@ void LSObject::std_add_field(LSObject* object, const char* name, LSValue* var) {
 }
 
 LSValue* LSObject::getField(std::string name) {
-	return this->values.at(name);
+	auto field = shape->find(name);
+	if (!field) throw std::out_of_range(name);
+	return slots[field->slot];
 }
 
 LSArray<LSValue*>* LSObject::ls_get_keys(const LSObject* const object) {
 	auto keys = new LSArray<LSValue*>();
-	for (auto i = object->values.begin(); i != object->values.end(); i++) {
-		keys->push_inc(new LSString(i->first));
+	for (const auto& f : object->shape->fields) {
+		keys->push_inc(new LSString(f.first));
 	}
 	if (object->refs == 0) delete object;
 	return keys;
@@ -52,8 +68,8 @@ LSArray<LSValue*>* LSObject::ls_get_keys(const LSObject* const object) {
 
 LSArray<LSValue*>* LSObject::ls_get_values(const LSObject* const object) {
 	auto v = new LSArray<LSValue*>();
-	for (auto i = object->values.begin(); i != object->values.end(); i++) {
-		v->push_clone(i->second);
+	for (const auto& f : object->shape->fields) {
+		v->push_clone(object->slots[f.second.slot]);
 	}
 	if (object->refs == 0) delete object;
 	return v;
@@ -62,9 +78,11 @@ LSArray<LSValue*>* LSObject::ls_get_values(const LSObject* const object) {
 template <class F>
 LSObject* base_map(const LSObject* object, F function) {
 	auto result = new LSObject();
-	for (auto v : object->values) {
-		auto r = ls::call<LSValue*>(function, ls::clone(v.second));
-		result->values.insert({v.first, r->move_inc()});
+	result->shape = object->shape->shared ? object->shape : object->shape->copy();
+	result->slots.reserve(object->slots.size());
+	for (auto v : object->slots) {
+		auto r = ls::call<LSValue*>(function, ls::clone(v));
+		result->slots.push_back(r->move_inc());
 	}
 	LSValue::delete_temporary(object);
 	return result;
@@ -82,16 +100,31 @@ bool LSObject::ls_in(const LSObject* const object, const LSValue* value) {
 	return object->in(value);
 }
 
+/*
+ * Miss of the inline cache of a compiled field access : remember the field of the shape of the object
+ */
+LSValue* LSObject::attr_cached(VM* vm, LSValue* object, char* key, const ShapeField** cache) {
+	if (object->type == OBJECT and object->refs > 0) {
+		auto shape = ((LSObject*) object)->shape;
+		if (shape->shared) {
+			if (auto field = shape->find(key)) {
+				*cache = field;
+			}
+		}
+	}
+	return object->attr(vm, key);
+}
+
 /*
  * LSValue methods
  */
 
 bool LSObject::to_bool() const {
-	return values.size() > 0;
+	return slots.size() > 0;
 }
 
 bool LSObject::ls_not() const {
-	auto r = values.size() == 0;
+	auto r = slots.size() == 0;
 	LSValue::delete_temporary(this);
 	return r;
 }
@@ -104,12 +137,20 @@ bool LSObject::eq(const LSValue* v) const {
 			return false;
 		if (clazz && *clazz != *obj->clazz)
 			return false;
-		if (values.size() != obj->values.size())
+		if (slots.size() != obj->slots.size())
 			return false;
-		auto i = values.begin();
-		auto j = obj->values.begin();
-		for (; i != values.end(); ++i, ++j) {
-			if (i->first != j->first or *i->second != *j->second)
+		// Same shape : same fields in the same slots
+		if (shape == obj->shape) {
+			for (size_t i = 0; i < slots.size(); ++i) {
+				if (*slots[i] != *obj->slots[i])
+					return false;
+			}
+			return true;
+		}
+		auto i = shape->fields.begin();
+		auto j = obj->shape->fields.begin();
+		for (; i != shape->fields.end(); ++i, ++j) {
+			if (i->first != j->first or *slots[i->second.slot] != *obj->slots[j->second.slot])
 				return false;
 		}
 		return true;
@@ -125,29 +166,40 @@ bool LSObject::lt(const LSValue* v) const {
 			return false;
 		if (clazz && *clazz != *obj->clazz)
 			return *clazz < *obj->clazz;
-		auto i = values.begin();
-		auto j = obj->values.begin();
-		while (i != values.end()) {
-			if (j == obj->values.end())
+		auto i = shape->fields.begin();
+		auto j = obj->shape->fields.begin();
+		while (i != shape->fields.end()) {
+			if (j == obj->shape->fields.end())
 				return false;
 			// i < j => true
 			// j < i => false
 			int x = i->first.compare(j->first);
 			if (x < 0) return true;
 			if (x > 0) return false;
-			if (*i->second != *j->second) {
-				return *i->second < *j->second;
+			auto a = slots[i->second.slot];
+			auto b = obj->slots[j->second.slot];
+			if (*a != *b) {
+				return *a < *b;
 			}
 			++i; ++j;
 		}
-		return j != obj->values.end();
+		return j != obj->shape->fields.end();
 	}
 	return LSValue::lt(v);
 }
 
+size_t LSObject::hash() const {
+	size_t h = type;
+	for (const auto& field : shape->fields) {
+		h = h * 31 + std::hash<std::string>()(field.first);
+		h = h * 31 + slots[field.second.slot]->hash();
+	}
+	return h;
+}
+
 bool LSObject::in(const LSValue* key) const {
-	for (auto i = values.begin(); i != values.end(); i++) {
-		if (*i->second == *key) {
+	for (auto v : slots) {
+		if (*v == *key) {
 			ls::release(key);
 			LSValue::delete_temporary(this);
 			return true;
@@ -159,11 +211,10 @@ bool LSObject::in(const LSValue* key) const {
 }
 
 LSValue* LSObject::attr(VM* vm, const std::string& key) const {
-	auto i = values.find(key);
-	if (i != values.end()) {
-		auto v = i->second;
+	if (auto field = shape->find(key)) {
+		auto v = slots[field->slot];
 		if (refs == 0) {
-			((LSObject*) this)->values.erase(key);
+			((LSObject*) this)->slots[field->slot] = nullptr;
 			LSValue::delete_temporary(this);
 			v->refs--;
 		}
@@ -177,24 +228,26 @@ LSValue** LSObject::attrL(const std::string& key) {
 	if (readonly) {
 		throw vm::ExceptionObj(vm::Exception::CANT_MODIFY_READONLY_OBJECT);
 	}
-	try {
-		return &values.at(key);
-	} catch (std::exception& e) {
-		values.insert({key, LSNull::get()});
-		return &values[key];
+	if (auto field = shape->find(key)) {
+		return &slots[field->slot];
 	}
+	shape = shape->add(key);
+	slots.push_back(LSNull::get());
+	return &slots.back();
 }
 
 int LSObject::abso() const {
-	return values.size();
+	return slots.size();
 }
 
 LSValue* LSObject::clone() const {
 	if (native) return (LSValue*) this;
 	LSObject* obj = new LSObject();
 	obj->clazz = clazz;
-	for (auto i = values.begin(); i != values.end(); i++) {
-		obj->values.insert({i->first, i->second->clone_inc()});
+	obj->shape = shape->shared ? shape : shape->copy();
+	obj->slots.reserve(slots.size());
+	for (auto v : slots) {
+		obj->slots.push_back(v->clone_inc());
 	}
 	return obj;
 }
@@ -203,11 +256,11 @@ std::ostream& LSObject::dump(std::ostream& os, int level) const {
 	if (clazz != nullptr) os << clazz->clazz->name << " ";
 	os << "{";
 	if (level > 0) {
-		for (auto i = values.begin(); i != values.end(); i++) {
-			if (i != values.begin()) os << ", ";
+		for (auto i = shape->fields.begin(); i != shape->fields.end(); i++) {
+			if (i != shape->fields.begin()) os << ", ";
 			os << i->first;
 			os << ": ";
-			i->second->dump(os, level - 1);
+			slots[i->second.slot]->dump(os, level - 1);
 		}
 	} else {
 		os << " ... ";
@@ -218,10 +271,10 @@ std::ostream& LSObject::dump(std::ostream& os, int level) const {
 
 std::string LSObject::json() const {
 	std::string res = "{";
-	for (auto i = values.begin(); i != values.end(); i++) {
-		if (i != values.begin()) res += ",";
+	for (auto i = shape->fields.begin(); i != shape->fields.end(); i++) {
+		if (i != shape->fields.begin()) res += ",";
 		res += "\"" + i->first + "\":";
-		std::string json = i->second->json();
+		std::string json = slots[i->second.slot]->json();
 		res += json;
 	}
 	return res + "}";
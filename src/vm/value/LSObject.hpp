@@ -2,6 +2,7 @@
 #define LSOBJECT_HPP_
 
 #include "../LSValue.hpp"
+#include "../Shape.hpp"
 
 namespace ls {
 
@@ -11,7 +12,12 @@ class LSObject : public LSValue {
 public:
 	static LSObject* constructor();
 
-	std::map<std::string, LSValue*> values;
+	/*
+	 * The fields : the shape gives the slot of each field.
+	 * Keep them first, the compiled inline caches read them directly (Object_type).
+	 */
+	Shape* shape;
+	std::vector<LSValue*> slots;
 	LSClass* clazz;
 	bool readonly;
 
@@ -23,17 +29,20 @@ public:
 	void addField(const char* name, LSValue* value);
 	static void std_add_field(LSObject* object, const char* name, LSValue* value);
 	LSValue* getField(std::string name);
+	void clear();
 	static LSArray<LSValue*>* ls_get_keys(const LSObject* const object);
 	static LSArray<LSValue*>* ls_get_values(const LSObject* const object);
 	template <class F>
 	static LSObject* ls_map(const LSObject* const object, F fun);
 	static bool ls_in(const LSObject* const object, const LSValue* value);
+	static LSValue* attr_cached(VM* vm, LSValue* object, char* key, const ShapeField** cache);
 
 	/** LSValue methods **/
 	bool to_bool() const override;
 	bool ls_not() const override;
 	bool eq(const LSValue*) const override;
 	bool lt(const LSValue*) const override;
+	size_t hash() const override;
 	bool in(const LSValue*) const override;
 	LSValue* attr(VM* vm, const std::string& key) const override;
 	LSValue** attrL(const std::string& key) override;
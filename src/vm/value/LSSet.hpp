@@ -2,6 +2,7 @@
 #define LS_SET_BASE
 
 #include "../LSValue.hpp"
+#include "HashIndex.hpp"
 #include <set>
 
 namespace ls {
@@ -12,8 +13,29 @@ struct lsset_less {
 };
 
 template <typename T>
-class LSSet : public LSValue, public std::set<T, lsset_less<T>> {
+class LSSet : public LSValue, protected std::set<T, lsset_less<T>> {
+	typedef std::set<T, lsset_less<T>> base;
+	struct key_of {
+		T operator () (typename base::iterator it) const { return *it; }
+	};
+	mutable HashIndex<T, typename base::iterator, key_of> index;
+
 public:
+	/*
+	 * The tree is only read from outside, the mutations go through the indexed operations below
+	 */
+	using typename base::iterator;
+	using typename base::const_iterator;
+	using typename base::value_type;
+	using base::begin;
+	using base::end;
+	using base::rbegin;
+	using base::rend;
+	using base::size;
+	using base::empty;
+	using base::lower_bound;
+	using base::upper_bound;
+
 	static LSSet<T>* constructor();
 
 	LSSet();
@@ -37,6 +59,23 @@ public:
 	static bool std_in(const LSSet<T>* const set, const LSValue* value);
 	static bool std_in_v(const LSSet<T>* const set, T value);
 
+	/*
+	 * Tree operations, also maintaining the hash index
+	 */
+	typename base::iterator find(const T& value) const;
+	size_t count(const T& value) const;
+	std::pair<typename base::iterator, bool> insert(const T& value);
+	typename base::iterator insert(typename base::const_iterator hint, const T& value);
+	template <class It>
+	void insert(It first, It last);
+	template <class... Args>
+	std::pair<typename base::iterator, bool> emplace(Args&&... args);
+	typename base::iterator erase(typename base::const_iterator it);
+	typename base::iterator erase(typename base::const_iterator first, typename base::const_iterator last);
+	size_t erase(const T& value);
+	void clear();
+	LSSet<T>& operator = (const LSSet<T>& other);
+
 	/*
 	 * LSValue methods
 	 */
@@ -13,7 +13,7 @@ namespace ls {
 
 template <>
 inline bool lsset_less<LSValue*>::operator()(LSValue* lhs, LSValue* rhs) const {
-	return *lhs < *rhs;
+	return lhs != rhs and *lhs < *rhs;
 }
 
 template <typename T>
@@ -61,9 +61,8 @@ int LSSet<T>::std_size(const LSSet<T>* const set) {
 
 template <>
 inline bool LSSet<LSValue*>::std_insert(LSSet<LSValue*>* set, LSValue* value) {
-	auto it = set->lower_bound(value);
-	if (it == set->end() || (**it != *value)) {
-		set->insert(it, value->move_inc());
+	if (set->find(value) == set->end()) {
+		set->insert(value->move_inc());
 		LSValue::delete_temporary(set);
 		return true;
 	}
@@ -85,9 +84,8 @@ inline bool LSSet<T>::std_insert(LSSet<T>* set, T value) {
 
 template <>
 inline void LSSet<LSValue*>::vinsert(LSSet<LSValue*>* set, LSValue* value) {
-	auto it = set->lower_bound(value);
-	if (it == set->end() || (**it != *value)) {
-		set->insert(it, value->move_inc());
+	if (set->find(value) == set->end()) {
+		set->insert(value->move_inc());
 	} else {
 		LSValue::delete_temporary(value);
 	}
@@ -135,6 +133,94 @@ bool LSSet<T>::std_contains(const LSSet<T>* const set, T value) {
 	return r;
 }
 
+/*
+ * Tree operations
+ */
+template <typename T>
+typename LSSet<T>::base::iterator LSSet<T>::find(const T& value) const {
+	if (!index.valid) {
+		if (this->size() < decltype(index)::MIN_SIZE) {
+			return base::find(value);
+		}
+		index.build(*this);
+	}
+	typename base::iterator it;
+	return index.find(value, it) ? it : this->end();
+}
+
+template <typename T>
+size_t LSSet<T>::count(const T& value) const {
+	return find(value) != this->end();
+}
+
+template <typename T>
+std::pair<typename LSSet<T>::base::iterator, bool> LSSet<T>::insert(const T& value) {
+	auto r = base::insert(value);
+	if (r.second) index.add(r.first);
+	return r;
+}
+
+template <typename T>
+typename LSSet<T>::base::iterator LSSet<T>::insert(typename base::const_iterator hint, const T& value) {
+	auto size = this->size();
+	auto it = base::insert(hint, value);
+	if (this->size() != size) index.add(it);
+	return it;
+}
+
+template <typename T>
+template <class It>
+void LSSet<T>::insert(It first, It last) {
+	base::insert(first, last);
+	index.clear();
+}
+
+template <typename T>
+template <class... Args>
+std::pair<typename LSSet<T>::base::iterator, bool> LSSet<T>::emplace(Args&&... args) {
+	auto r = base::emplace(std::forward<Args>(args)...);
+	if (r.second) index.add(r.first);
+	return r;
+}
+
+template <typename T>
+typename LSSet<T>::base::iterator LSSet<T>::erase(typename base::const_iterator it) {
+	index.remove(it);
+	return base::erase(it);
+}
+
+template <typename T>
+typename LSSet<T>::base::iterator LSSet<T>::erase(typename base::const_iterator first, typename base::const_iterator last) {
+	for (auto it = first; it != last; ++it) {
+		index.remove(it);
+	}
+	return base::erase(first, last);
+}
+
+template <typename T>
+size_t LSSet<T>::erase(const T& value) {
+	auto it = find(value);
+	if (it == this->end()) return 0;
+	erase(it);
+	return 1;
+}
+
+template <typename T>
+void LSSet<T>::clear() {
+	index.clear();
+	base::clear();
+}
+
+/*
+ * Copy of the tree only, the index is built again at the next lookup
+ */
+template <typename T>
+LSSet<T>& LSSet<T>::operator = (const LSSet<T>& other) {
+	index.clear();
+	base::operator = (other);
+	return *this;
+}
+
 template <typename T>
 bool LSSet<T>::to_bool() const {
 	return !this->empty();
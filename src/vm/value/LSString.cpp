@@ -9,6 +9,7 @@
 #include <string.h>
 #include "../../util/utf8.h"
 #include "../VM.hpp"
+#include "../StringTable.hpp"
 #include "../../environment/Environment.hpp"
 
 namespace ls {
@@ -59,16 +60,18 @@ LSString::LSString(const char value) : LSValue(STRING), std::string(std::string(
 LSString::LSString(const char* value) : LSValue(STRING), std::string(value) {}
 LSString::LSString(const std::string& value) : LSValue(STRING), std::string(value) {}
 LSString::LSString(const Json& json) : LSValue(STRING), std::string(json.get<std::string>()) {}
+LSString::LSString(const std::string& value, bool native) : LSValue(STRING, 1 << 30, native), std::string(value) {}
 
 LSString::~LSString() {}
 
 LSString* LSString::charAt(const LSString* const string, int index) {
-	return new LSString(string->operator[] (index));
+	return StringTable::character(string->operator[] (index));
 }
 
 LSString* LSString::codePointAt(const LSString* const string, int index) {
 	char buff[5];
 	u_int32_t c = u8_char_at((char*) string->c_str(), index);
+	if (c > 0 and c < 128) return StringTable::character(c);
 	u8_toutf8(buff, 5, &c, 1);
 	return new LSString(buff);
 }
@@ -255,6 +258,7 @@ LSValue* LSString::mul(LSValue* v) {
 	}
 	auto number = static_cast<LSNumber*>(v);
 	std::string r;
+	if (number->value > 0) r.reserve(size() * (size_t) number->value);
 	for (int i = 0; i < number->value; ++i) {
 		r += *this;
 	}
@@ -308,6 +312,8 @@ LSValue* LSString::div(LSValue* v) {
 }
 
 bool LSString::eq(const LSValue* v) const {
+	// Interned strings
+	if (this == v) return true;
 	if (v->type == STRING) {
 		auto str = static_cast<const LSString*>(v);
 		return compare(*str) == 0;
@@ -316,6 +322,7 @@ bool LSString::eq(const LSValue* v) const {
 }
 
 bool LSString::lt(const LSValue* v) const {
+	if (this == v) return false;
 	if (v->type == STRING) {
 		auto str = static_cast<const LSString*>(v);
 		return compare(*str) < 0;
@@ -339,6 +346,7 @@ LSValue* LSString::at(const LSValue* key) const {
 		const LSNumber* n = static_cast<const LSNumber*>(key);
 		char buff[5];
 		u_int32_t c = u8_char_at((char*) this->c_str(), (int) n->value);
+		if (c > 0 and c < 128) return StringTable::character(c);
 		u8_toutf8(buff, 5, &c, 1);
 		return new LSString(buff);
 	}
@@ -370,6 +378,10 @@ int LSString::abso() const {
 	return unicode_length();
 }
 
+size_t LSString::hash() const {
+	return std::hash<std::string>()(*this);
+}
+
 std::ostream& LSString::print(std::ostream& os) const {
 	os << (const std::string&) *this;
 	return os;
@@ -26,6 +26,14 @@ public:
 	static bool iterator_end(iterator* it);
 	static LSString* constructor_1();
 	static LSString* constructor_2(char* s);
+	// Replace an interned string by its own copy before modifying it in place
+	static void unshare(LSValue** x) {
+		if ((*x)->native and (*x)->type == STRING) {
+			auto copy = new LSString((const std::string&) *static_cast<LSString*>(*x));
+			copy->refs = 1;
+			*x = copy;
+		}
+	}
 
 	LSString();
 	LSString(char);
@@ -72,6 +80,7 @@ public:
 	LSValue* range(int start, int end) const override;
 
 	int abso() const override;
+	size_t hash() const override;
 
 	LSValue* clone() const override;
 
@@ -82,6 +91,10 @@ public:
 	std::string escape_control_characters() const;
 
 	LSValue* getClass(VM* vm) const override;
+
+private:
+	friend class StringTable;
+	LSString(const std::string& value, bool native);
 };
 
 }
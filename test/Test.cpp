@@ -166,6 +166,7 @@ Test::Input Test::file_v1(const std::string& file_name) {
 
 ls::Environment& Test::getEnv(bool legacy) {
 	auto thread = std::this_thread::get_id();
+	std::lock_guard<std::mutex> lock(mutex);
 	auto& map = legacy ? envs_legacy : envs;
 	auto i = map.find(thread);
 	if (i != map.end()) {
@@ -182,13 +183,25 @@ ls::Result Test::Input::run(bool display_errors, bool ops) {
 
 	auto& env = test->getEnv(v1);
 	env.operation_limit = ops ? ls::VM::DEFAULT_OPERATION_LIMIT : this->operation_limit;
+	auto previous_optimization = env.optimization;
+	if (optimization_level != -1) {
+		env.optimization = optimization_level;
+	}
+	env.lazy = lazy_compilation;
+	env.compile_threads = threads;
+	env.batch_operations = batched_operations;
 	ls::Program program { env, code, file_name };
 	program.context = ctx;
 	env.analyze(program);
 	env.compile(program);
 	env.execute(program, false, false, ops or this->operation_limit > 0);
+	env.optimization = previous_optimization;
+	env.lazy = false;
+	env.compile_threads = 1;
+	env.batch_operations = false;
 
 	this->result = program.result;
+	std::unique_lock<std::mutex> lock(test->mutex);
 	test->obj_created += result.objects_created;
 	test->obj_deleted += result.objects_deleted;
 	test->mpz_obj_created += result.mpz_objects_created;
@@ -200,6 +213,7 @@ ls::Result Test::Input::run(bool display_errors, bool ops) {
 	test->parse_time += result.parse_time;
 	test->compilation_time += result.compilation_time;
 	test->execution_time += result.execution_time;
+	lock.unlock();
 
 	if (display_errors) {
 		for (const auto& error : result.errors) {
@@ -226,6 +240,7 @@ void Test::Input::pass(const std::string& expected) {
 			oss << C_RED << " (" << (result.objects_created - result.objects_deleted) << " leaked)" << END_COLOR;
 		if (result.mpz_objects_created != result.mpz_objects_deleted)
 			oss << C_RED << " (" << (result.mpz_objects_created - result.mpz_objects_deleted) << " mpz leaked)" << END_COLOR;
+		std::lock_guard<std::mutex> lock(test->mutex);
 		failed_tests.push_back(oss.str());
 	}
 }
@@ -240,6 +255,7 @@ void Test::Input::fail(const std::string& expected, const std::string& actual) {
 	std::cout << std::endl;
 	if (result.objects_created != result.objects_deleted)
 		oss << C_RED << " (" << (result.objects_created - result.objects_deleted) << " leaked)" << END_COLOR;
+	std::lock_guard<std::mutex> lock(test->mutex);
 	failed_tests.push_back(oss.str());
 }
 
@@ -249,6 +265,7 @@ void Test::Input::disable() {
 	std::ostringstream oss;
 	oss << C_PURPLE << "DISA" << END_COLOR << " : " << label;
 	std::cout << oss.str() << std::endl;
+	std::lock_guard<std::mutex> lock(test->mutex);
 	disabled_tests.push_back(oss.str());
 }
 
@@ -422,6 +439,22 @@ Test::Input& Test::Input::ops_limit(long int ops) {
 	this->operation_limit = ops;
 	return *this;
 }
+Test::Input& Test::Input::optimization(int level) {
+	this->optimization_level = level;
+	return *this;
+}
+Test::Input& Test::Input::lazy() {
+	this->lazy_compilation = true;
+	return *this;
+}
+Test::Input& Test::Input::compile_threads(int threads) {
+	this->threads = threads;
+	return *this;
+}
+Test::Input& Test::Input::batch_operations() {
+	this->batched_operations = true;
+	return *this;
+}
 Test::Input& Test::Input::context(ls::Context* ctx) {
 	this->ctx = ctx;
 	return *this;
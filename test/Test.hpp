@@ -7,6 +7,8 @@
 #include "../src/vm/value/LSNumber.hpp"
 #include "../src/colors.h"
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include "../src/environment/Environment.hpp"
 #include "../src/analyzer/Result.hpp"
 
@@ -14,9 +16,11 @@ class Test {
 private:
 	std::map<std::thread::id, std::unique_ptr<ls::Environment>> envs;
 	std::map<std::thread::id, std::unique_ptr<ls::Environment>> envs_legacy;
-	int total = 0;
-	int success_count = 0;
-	int disabled = 0;
+	// One environment per thread, the suites may run in parallel (see Test::all)
+	std::mutex mutex;
+	std::atomic<int> total { 0 };
+	std::atomic<int> success_count { 0 };
+	std::atomic<int> disabled { 0 };
 	double parse_time = 0;
 	double compilation_time = 0;
 	double execution_time = 0;
@@ -62,6 +66,7 @@ public:
 			oss << C_RED << "FAIL " << END_COLOR << ": " << label;
 			oss << "  =/=>  " << expected << "  got  " << value << std::endl;
 			std::cout << oss.str();
+			std::lock_guard<std::mutex> lock(mutex);
 			failed_tests.push_back(oss.str());
 		}
 	}
@@ -105,6 +110,10 @@ public:
 		double compilation_time = 0;
 		double execution_time = 0;
 		long int operation_limit = -1;
+		int optimization_level = -1;
+		bool lazy_compilation = false;
+		int threads = 1;
+		bool batched_operations = false;
 		ls::Result result;
 		ls::Context* ctx = nullptr;
 
@@ -123,6 +132,10 @@ public:
 		void type(const ls::Type*);
 		Input& timeout(int ms);
 		Input& ops_limit(long int ops);
+		Input& optimization(int level);
+		Input& lazy();
+		Input& compile_threads(int threads);
+		Input& batch_operations();
 		Input& context(ls::Context* ctx);
 
 		ls::Result run(bool display_errors = true, bool ops = false);
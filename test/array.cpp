@@ -663,6 +663,17 @@ void Test::test_arrays() {
 	// TODO functions inconnues
 	DISABLED_code("let h = [1, 'text', [1,2,3], x -> x + 1] h[2].push('test') h[0] = [h[3](h[0]), h[3](h[1])] h").equals("[[2, 'text1'], 'text', [1, 2, 3, 'test'], <function>]");
 
+	section("Fused map / filter / fold");
+	code("[1, 2, 3, 4].map(x -> x * 10).filter(x -> x > 15)").equals("[20, 30, 40]");
+	code("[1, 2, 3, 4, 5].filter(x -> x % 2).map(x -> x * x).sum()").equals("35");
+	code("[1.5, 2.5, 3].map(x -> x * 2).sum()").equals("14");
+	code("['a', 'b', 'c'].map(x -> x + '!').filter(x -> x != 'b!').foldLeft((a, x) -> a + x, '')").equals("'a!c!'");
+	code("[1, 2, 3].map(x -> [x]).map(x -> x[0] + 1)").equals("[2, 3, 4]");
+	code("['a', 'bb', 'ccc'].filter(x -> x.size() > 1).map(x -> x.size())").equals("[2, 3]");
+	code("[1, 2, 3].map(x -> x + 1).iter(x -> System.print(x))").output("2\n3\n4\n");
+	code("[1..5].map(x -> x * 2).filter(x -> x > 4)").equals("[6, 8, 10]");
+	code("[].map(x -> x).filter(x -> x)").equals("[]");
+
 	section("Array [legacy] pushAll");
 	code_v1("var a = [] pushAll(a, ['a', 'b', 'c']) a").equals("['a', 'b', 'c']");
 
@@ -1,4 +1,6 @@
 #include "Test.hpp"
+#include <fstream>
+#include <filesystem>
 
 void Test::test_files() {
 
@@ -60,9 +62,25 @@ void Test::test_files() {
 	code("include('test/code/include/car.class.leek') let ferrari = new Car() ferrari.price").equals("300000");
 	code("include('test/code/include/hypot.leek') hypot(3, 4)").equals("5");
 	code("include('test/code/include/folder/fact.leek')").equals("3628800");
+	code("include('test/code/include/basic.leek') include('test/code/include/squared.leek') squared(5)").equals("25");
 	code("include('test/code/include/exception.leek') except()").exception(ls::vm::Exception::DIVISION_BY_ZERO, {
 		{"folder/crash.leek", "crash", 5},
 		{"test/code/include/exception.leek", "except", 4},
 		{"test", "main", 1}
 	});
+
+	section("include() cache");
+	{
+		auto path = std::filesystem::path("build/test-include-cache.leek");
+		std::ofstream(path) << "'one'";
+		code("include('build/test-include-cache.leek')").equals("'one'");
+		auto time = std::filesystem::last_write_time(path);
+		std::ofstream(path) << "'three'";
+		std::filesystem::last_write_time(path, time);
+		code("include('build/test-include-cache.leek')").equals("'three'");
+		std::ofstream(path) << "'seven'";
+		std::filesystem::last_write_time(path, time + std::chrono::seconds(1));
+		code("include('build/test-include-cache.leek')").equals("'seven'");
+		std::filesystem::remove(path);
+	}
 }
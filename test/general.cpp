@@ -1,6 +1,7 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <filesystem>
 #include "Test.hpp"
 #include "../src/analyzer/Context.hpp"
 #include "../src/analyzer/lexical/LexicalAnalyzer.hpp"
@@ -8,8 +9,11 @@
 #include "../src/analyzer/semantic/SemanticAnalyzer.hpp"
 #include "../src/analyzer/error/Error.hpp"
 #include "../src/analyzer/Program.hpp"
+#include "../src/util/Util.hpp"
+#include "../src/CLI.hpp"
 #include "../src/vm/value/LSNumber.hpp"
 #include "../src/vm/value/LSObject.hpp"
+#include "../src/vm/value/LSArray.hpp"
 #include "../src/standard/StandardLibrary.hpp"
 
 void Test::test_general() {
@@ -217,6 +221,188 @@ void Test::test_general() {
 	section("Assignments with +=");
 	code("var a = 10 a += 0.5 a").equals("10.5");
 
+	section("Optimization levels");
+	code("var s = 0 for var i = 0; i < 1000; ++i { s += i } s").optimization(0).equals("499500");
+	code("var s = 0 for var i = 0; i < 1000; ++i { s += i } s").optimization(2).equals("499500");
+	code("let f = x -> x * 2 var s = 0 for var i = 0; i < 100; ++i { s += f(i) } s").optimization(3).equals("9900");
+	code("var a = [] for var i = 0; i < 10; ++i { a.push(i * 1.5) } a").optimization(3).equals("[0, 1.5, 3, 4.5, 6, 7.5, 9, 10.5, 12, 13.5]");
+	file("test/code/primes.leek").optimization(2).equals("78498");
+
+	section("Lazy compilation");
+	code("let f = x -> x + 1 f(12)").lazy().equals("13");
+	code("let f = x -> x + 1 let g = x -> x * 2 f(5)").lazy().equals("6");
+	code("let fib = n -> n < 2 ? n : fib(n - 1) + fib(n - 2) fib(20)").lazy().equals("6765");
+	code("[1, 2, 3].map(x -> x * 3)").lazy().equals("[3, 6, 9]");
+	code("class A { m() { return 12 } } new A().m()").lazy().equals("12");
+	file("test/code/primes.leek").lazy().equals("78498");
+
+	section("Parallel compilation");
+	code("let f = x -> x + 1 let g = x -> x * 2 f(5) + g(5)").compile_threads(4).equals("16");
+	code("let fib = n -> n < 2 ? n : fib(n - 1) + fib(n - 2) fib(20)").compile_threads(2).equals("6765");
+	code("'hello ' + [1, 2, 3].map(x -> x * 3)").compile_threads(3).equals("'hello [3, 6, 9]'");
+	code("class A { m() { return 12 } } new A().m()").compile_threads(4).equals("12");
+	file("test/code/primes.leek").compile_threads(4).equals("78498");
+	file("test/code/euler/pe062.leek").compile_threads(4).equals("127035954683");
+
+	section("Runtime symbols");
+	{
+		const auto& number = env.std.classes.at("Number");
+		test("Symbol Number.abs.0", env.std.symbol("Number.abs.0"), number->clazz->methods.at("abs").versions.at(0).addr);
+		test("Symbol Number.abs", env.std.symbol("Number.abs"), number->clazz->methods.at("abs").versions.at(0).addr);
+		test("Symbol Number", env.std.symbol("Number"), (void*) number->lsclass);
+		test("Unknown symbol", env.std.symbol("Number.unknown_method.0"), (void*) nullptr);
+	}
+
+	section("Code cache");
+	std::filesystem::remove_all("build/test-cache");
+	env.cache_directory = "build/test-cache";
+	for (int i = 0; i < 2; ++i) {
+		ls::Program program { env, "[1, 2, 3].map(x -> x * 2)", "test" };
+		env.analyze(program);
+		env.compile(program);
+		env.execute(program);
+		test("Code cache (run " + std::to_string(i + 1) + ")", program.result.value, std::string("[2, 4, 6]"));
+		test("Code cache (run " + std::to_string(i + 1) + ") cached", program.result.compilation_cached, i == 1);
+	}
+	env.cache_directory = "";
+	std::filesystem::remove_all("build/test-cache");
+
+	section("Native compilation");
+	std::vector<std::pair<std::string, std::string>> native_programs = {
+		{ "12 * 5", "60" },
+		{ "'hello ' + [1, 2, 3].map(x -> x * 2)", "'hello [2, 4, 6]'" },
+		{ "let f = x -> x < 2 ? x : f(x - 1) + f(x - 2) f(15)", "610" },
+		{ "var s = 0.5 for i in [1..10] { s += i } s", "55.5" },
+		{ "[null, true, 'a']", "[null, true, 'a']" },
+		{ "12m * 12m", "144" },
+	};
+	for (size_t i = 0; i < native_programs.size(); ++i) {
+		auto library = "build/test-native-" + std::to_string(i) + ".so";
+		{
+			ls::Program program { env, native_programs[i].first, "test" };
+			env.analyze(program);
+			env.compile_native(program, library);
+			test("Native compilation " + std::to_string(i + 1), program.result.compilation_success, true);
+		}
+		ls::Program native { env, "", library };
+		env.load_native(native);
+		env.execute(native);
+		test("Native program " + std::to_string(i + 1), native.result.value, native_programs[i].second);
+		test("Native program " + std::to_string(i + 1) + " objects", native.result.objects_created, native.result.objects_deleted);
+		std::filesystem::remove(library);
+	}
+	{
+		ls::Program program { env, "var x = 'hello' throw", "test" };
+		env.analyze(program);
+		env.compile_native(program, "build/test-native-exception.so");
+		ls::Program native { env, "", "build/test-native-exception.so" };
+		env.load_native(native);
+		env.execute(native);
+		test("Native exception", native.result.exception.type, ls::vm::Exception::EXCEPTION);
+		std::filesystem::remove("build/test-native-exception.so");
+	}
+
+	section("Value pool");
+	{
+		ls::Program program { env, "var a = [] for i in [1..1000] { a += ['a' + i, i * 0.5, {x: i}] } a.size()", "test" };
+		env.analyze(program);
+		env.compile(program);
+		env.execute(program);
+		test("Pooled program", program.result.value, "3000");
+		test("Pool empty after execution", program.result.objects_created, program.result.objects_deleted);
+		test("Pool released", ls::Pool::current, (ls::Pool*) nullptr);
+	}
+	{
+		auto pool = new ls::Pool();
+		ls::Pool::current = pool;
+		auto array = new ls::LSArray<int>({ 1, 2, 3 });
+		ls::Pool::current = nullptr;
+		pool->release();
+		test("Pool kept by its values", pool->live, 1ul);
+		test("Value after the pool release", array->to_string(), "[1, 2, 3]");
+		delete array; // The pool is freed with its last block
+	}
+
+	section("Profiler");
+	{
+		env.profile_output = "build/test-profile.folded";
+		ls::Program program { env, "function hot_work(x) { var s = 0 for i in [0..x] { s += i % 7 } return s } var t = 0 for j in [1..300] { t += hot_work(10000) } t", "test" };
+		env.analyze(program);
+		env.compile(program);
+		env.execute(program);
+		test("Profiled program", program.result.value, "8999400");
+		test("Profile report", program.result.profile.find("Profile:") == 0, true);
+		test("Profile hot function", program.result.profile.find("hot_work") != std::string::npos, true);
+		test("Profile folded stacks", ls::Util::read_file("build/test-profile.folded").find("main;hot_work") != std::string::npos, true);
+		std::filesystem::remove("build/test-profile.folded");
+
+		ls::Program broken { env, "var x = ", "test" };
+		env.analyze(broken);
+		env.compile(broken);
+		env.execute(broken);
+		test("No profile without compilation", std::filesystem::exists("build/test-profile.folded"), false);
+		env.profile_output = "";
+	}
+
+	section("Server");
+	{
+		// Two requests, a malformed header with its body, a third request
+		std::istringstream in("5\n1 + 2\n9\n'a' + 'b'\n3 x\nabc\n11\nprint(42) 1");
+		std::ostringstream out;
+		ls::CLI cli;
+		ls::CLI_options options;
+		cli.server(options, in, out);
+		std::vector<std::string> responses;
+		std::istringstream lines(out.str());
+		for (std::string line; std::getline(lines, line);) responses.push_back(line);
+		test("Server responses", responses.size(), (size_t) 4);
+		test("Server first response", responses.at(0).find("\"res\":\"3\"") != std::string::npos, true);
+		test("Server second response", responses.at(1).find("\"res\":\"'ab'\"") != std::string::npos, true);
+		test("Server malformed header", responses.at(2), std::string("{\"success\":false,\"error\":\"wrong length\"}"));
+		test("Server after a malformed header", responses.at(3).find("\"res\":\"1\"") != std::string::npos, true);
+		test("Server output", responses.at(3).find("\"output\":\"42\\n\"") != std::string::npos, true);
+	}
+
 	section("File");
 	file("test/code/trivial.leek").equals("2");
+
+	section("Reference counting elision");
+	{
+		ls::Program program { env, "var n = 0 for x in ['a', 'b', 'c'] {} for y in ['d', 'e'] { n += y.size() } n", "test" };
+		env.analyze(program);
+		env.compile(program);
+		env.execute(program);
+		test("Elided program", program.result.value, "2");
+		test("Elided operations", program.result.refs_elided > 0, true);
+		test("No leak", program.result.objects_created, program.result.objects_deleted);
+	}
+
+	section("Incremental lexing");
+	{
+		ls::File file { "test", "var a = 12\nvar b = a + 1 // TODO b\nvar c = 'c'\nprint(a is not b)", {}, nullptr };
+		file.tokens = ls::LexicalAnalyzer().analyze(&file);
+		file.tokens_read = true;
+		file.edit(15, 16, "beta");
+		file.edit(0, 0, "/* header */\n");
+		ls::File fresh { "test", file.code, {}, nullptr };
+		auto tokens = ls::LexicalAnalyzer().analyze(&fresh);
+		test("Edited code", file.code, std::string("/* header */\nvar a = 12\nvar beta = a + 1 // TODO b\nvar c = 'c'\nprint(a is not b)"));
+		test("Same tokens", file.tokens.size(), tokens.size());
+		bool same = true;
+		for (size_t t = 0; t < tokens.size() and t < file.tokens.size(); ++t) {
+			same = same and file.tokens[t].content == tokens[t].content and file.tokens[t].location.start.raw == tokens[t].location.start.raw and file.tokens[t].location.start.line == tokens[t].location.start.line;
+		}
+		test("Same locations", same, true);
+		test("Todo shifted", file.todos.size() == 1 and file.todos[0].location.start.line == 3, true);
+	}
+	{
+		ls::Program program { env, "var a = 1\nvar b = 2\nvar c = 'z\\q'", "test" };
+		env.analyze(program);
+		env.analyze(program);
+		test("Lexical error kept", program.result.errors.size() == 1 and program.result.errors[0].location.start.line == 3, true);
+		env.edit(program, 0, 0, "\n");
+		test("Lexical error shifted", program.result.errors.size() == 1 and program.result.errors[0].location.start.line == 4, true);
+		env.edit(program, 31, 33, "");
+		test("Lexical error fixed", program.result.errors.size(), (size_t) 0);
+	}
 }
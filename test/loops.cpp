@@ -219,6 +219,20 @@ void Test::test_loops() {
 	section("Foreach - argument");
 	DISABLED_code("function main(r) { for x in [1, 2, 3] { for y in [4, 5, 6] { r += x * y }} r } main([])").equals("[4, 5, 6, 8, 10, 12, 12, 15, 18]");
 
+	section("Foreach - container on the stack");
+	code("var s = 0.0 for x in [0.5, 1.5, 2] { s += x } s").equals("4");
+	code("var s = 0 for x in ['a', 'bb', 'ccc'] { if x.size() > 2 { break } s += x.size() } s").equals("3");
+	code("var r = [] for x in [[1], [2, 3]] { r += x } r").equals("[[1], [2, 3]]");
+	code("var r = [] for x in [[1], 'a'] { r.push(x) } r").equals("[[1], 'a']");
+	code("function f() { for x in ['a', 'b'] { for y in [1, 2] { if y == 2 { return x + y } } } } f()").equals("'a2'");
+	code("var s = 0 for x in [for y in [1, 2, 3] { y * 2 }] { s += x } s").equals("12");
+	code("var r = [] for x in [for var i = 0; i < 3; i++ { 'a' + i }] { r += x } r").equals("['a0', 'a1', 'a2']");
+	code("var r = [] for x in [for y in [1, 2] { [y] }] { r += x } r").equals("[[1], [2]]");
+	code("var s = 0 for x in [1, 2, 3, 4].map(x -> x * 10) { s += x } s").equals("100");
+	code("var r = [] for x in ['a', 'bb', 'ccc'].filter(x -> x.size() > 1) { r += x } r").equals("['bb', 'ccc']");
+	code("var s = 0 for x in [1, 2, 3, 4].map(x -> x + 1).filter(x -> x % 2 == 0) { s += x } s").equals("6");
+	code("var r = [] for x in [[1], [2]].map(x -> x + [0]) { r += x } r").equals("[[1, 0], [2, 0]]");
+
 	header("Foreach - unknown container");
 	// TODO : unknown container iterator
 	// code("for x in ['hello', 12345][0] { print(x) }").equals("h\ne\nl\nl\no\n");
@@ -1,5 +1,6 @@
 #include "Test.hpp"
 #include "../src/type/Type.hpp"
+#include "../src/vm/value/LSMap.hpp"
 
 void Test::test_map() {
 	auto& env = getEnv();
@@ -228,4 +229,24 @@ void Test::test_map() {
 	code("['c' : 'c', 'a' : 'a', 'd' : 'd', 'b' : 'b'].minKey()").equals("'a'");
 	code("let a = ['c' : 'c', 'a' : 'a', 'd' : 'd', 'b' : 'b'] a.minKey()").equals("'a'");
 	code("[0 : 4.01, 42 : 20.5, 100 : 10, -1 : 4.99].minKey()").equals("-1");
+
+	section("Map hash index");
+	code("var m = [1: 1] for i in [0..99] { m.insert(i, i * 2) } m[42] + m[99]").equals("282");
+	code("var m = ['a': 1] for i in [0..49] { m.insert('k' + i, i) } m['k17'] + m['k49']").equals("66");
+	code("var m = [1: 1] for i in [0..99] { m.insert(i, i) } for i in [0..89] { m.erase(i) } [m.size(), 42 in m, 95 in m]").equals("[10, false, true]");
+	code("var m = [1: 1] for i in [0..99] { m.insert(i, i) } m.clear() m.insert(5, 12) [m.size(), m[5]]").equals("[1, 12]");
+	code("var m = [0.5: 1] for i in [0..39] { m.insert(i, i) } [m.size(), 12 in m, m.minKey()]").equals("[41, true, 0]");
+	code("var m = [1: 1] for i in [0..39] { m.insert(1024 * i, i) } [m[1024 * 37], 1024 * 40 in m]").equals("[37, false]");
+	code("var m = [[0]: 0] for i in [1..29] { m.insert([i, i], i) } [m[[12, 12]], [12] in m]").equals("[12, false]");
+	{
+		ls::LSMap<int, int> m;
+		for (int i = 0; i < 100; ++i) m.emplace(i, i);
+		m.find(0); // Builds the index
+		m.erase(m.lower_bound(10), m.lower_bound(90));
+		test("Index after range erase", m.size() == 20 and m.count(42) == 0 and m.find(95)->second == 95, true);
+		ls::LSMap<int, int> other;
+		for (int i = 0; i < 50; ++i) other.emplace(1000 + i, i);
+		m = other;
+		test("Index after assignment", m.size() == 50 and m.count(95) == 0 and m.find(1042)->second == 42, true);
+	}
 }
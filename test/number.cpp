@@ -210,6 +210,15 @@ void Test::test_numbers() {
 	code("var a = 20m; let b = a-- b").equals("20");
 	code("5--").error(ls::Error::Type::VALUE_MUST_BE_A_LVALUE, {"5"});
 
+	section("Shared small numbers");
+	code("var a = 5$ var b = 5$ a++ [a, b]").equals("[6, 5]");
+	code("var a = 5$ var b = 5$ --a [a, b]").equals("[4, 5]");
+	code("var a = 5$ var b = 5$ a += 10 [a, b]").equals("[15, 5]");
+	code("var a = [1, 'a'] var b = [1, 'b'] a[0] *= 7 [a, b]").equals("[[7, 'a'], [1, 'b']]");
+	code("var a = 12$ var b = 12$ a <<= 2 [a, b]").equals("[48, 12]");
+	code("var a = 1023$ var b = 1023$ ++a ++b [a, b]").equals("[1024, 1024]");
+	code("var a = [1, 2, 'a'] Array.remove(a, 0) var b = [1, 'b'] Array.remove(b, 0) + 1").equals("2");
+
 	section("Number.operator in");
 	// TODO idea : a in b returns true if a is a divisor of b
 	code("2 in 12").error(ls::Error::Type::VALUE_MUST_BE_A_CONTAINER, {"12"});
@@ -117,4 +117,16 @@ void Test::test_objects() {
 	code("{}.map(x -> x + 1)").equals("{}");
 	code("{x: 12, y: 5}.map(x -> x + 1)").equals("{x: 13, y: 6}");
 	code("{x: 'a', y: 'b'}.map(x -> x + ' !')").equals("{x: 'a !', y: 'b !'}");
+
+	section("Object shapes");
+	code("var r = 0 for o in [{a: 1, b: 2}, {b: 3, a: 4}, {a: 5}] { r += o.a } r").equals("10");
+	code("var s = 0 for i in [0..9] { var o = {x: i, y: 2} s += o.x + o.y } s").equals("65");
+	code("var o = {a: 1} o.b = 2 o.c = o.a + o.b [o, o.c]").equals("[{a: 1, b: 2, c: 3}, 3]");
+	code("let f = o -> o.v [f({v: 1}), f({w: 2, v: 'a'}), f({v: [1]})]").equals("[1, 'a', [1]]");
+	code("let a = {x: 1, y: 2} let b = {y: 2, x: 1} [a == b, a < {x: 1, y: 3}]").equals("[true, true]");
+	code("class A { let x = 5 } var s = 0 for i in [0..4] { s += new A().x } s").equals("25");
+	code("var j = '{' for i in [0..99] { j += (i ? ', ' : '') + '\"f' + i + '\": ' + i } let o = Json.decode(j + '}') [o.f0, o.f50, o.f99, Object.keys(o).size()]").equals("[0, 50, 99, 100]");
+	code("var j = '{' for i in [0..99] { j += (i ? ', ' : '') + '\"f' + i + '\": ' + i } var o = Json.decode(j + '}') o.f1 = 'x' o.g = 2 [o.f1, o.f2, o.g]").equals("['x', 2, 2]");
+	code("var o = {arr: [1]} o.arr[] = (o.b = 2) [o.arr, o.b]").equals("[[1, 2], 2]");
+	code("var o = {x: 1} o.x <=> o.y [o.x, o.y]").equals("[null, 1]");
 }
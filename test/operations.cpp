@@ -21,4 +21,14 @@ void Test::test_operations() {
 	section("Operation limit exceeded");
 	code("while true {}").ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
 	code("for ;; {}").ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
+
+	section("Batched operations");
+	code("2 * 3 + 4 * 5").batch_operations().operations(3);
+	code("[1, 2, 3]").batch_operations().operations(4);
+	code("(x -> x + 1)(12)").batch_operations().operations(3);
+	code("var a = 1 + 2 var b = System.operations a + b").batch_operations().equals("4");
+	code("while true {}").batch_operations().ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
+	code("for ;; {}").batch_operations().ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
+	code("for x in [1..1000000] { [x] }").batch_operations().ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
+	code("let f = x -> x + 1 var s = 0 while true { s = f(s) }").batch_operations().ops_limit(1000).exception(ls::vm::Exception::OPERATION_LIMIT_EXCEEDED);
 }
@@ -158,4 +158,10 @@ void Test::test_set() {
 
 	section("Set clone()");
 	code("let s = <1, 2, 3> [s]").equals("[<1, 2, 3>]");
+
+	section("Set hash index");
+	code("var s = <1> for i in [0..99] { s.insert(i) } [s.size(), s.contains(42), s.contains(100)]").equals("[100, true, false]");
+	code("var s = <'a'> for i in [0..49] { s.insert('k' + i) } ['k17' in s, 'k50' in s]").equals("[true, false]");
+	code("var s = <1> for i in [0..99] { s.insert(i) } for i in [0..89] { s.erase(i) } [s.size(), 42 in s, 95 in s]").equals("[10, false, true]");
+	code("var s = <1> for i in [0..99] { s.insert(i) } s.clear() s.insert(5) [s.size(), 5 in s]").equals("[1, true]");
 }
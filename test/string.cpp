@@ -318,4 +318,24 @@ void Test::test_strings() {
 	code("'bonjour'.right(1000)").equals("'bonjour'");
 	code("'bonjour'.right(-1)").equals("''");
 	code("String.right('hello how are you?', 8)").equals("'are you?'");
+
+	section("Interned strings");
+	code("var s = 'abc' s += 'd' [s, 'abc']").equals("['abcd', 'abc']");
+	code("function f(x) { x += '!' return x } [f('a'), f('a'), 'a']").equals("['a!', 'a!', 'a']");
+	code("var r = [] for i in [0..2] { var s = 'x' s += i r += s } r").equals("['x0', 'x1', 'x2']");
+	code("var m = ['a': 1] m['a'] = 2 m['b'] = 3 [m['a'], m['b'], m.size()]").equals("[2, 3, 2]");
+	code("var a = 'hello'.split('') a[0] += 'y' [a, 'hello'[0], 'h']").equals("[['hy', 'e', 'l', 'l', 'o'], 'h', 'h']");
+	code("var c = '' for x in 'abc' { x += '.' c += x } c").equals("'a.b.c.'");
+	code("['abc'[1] == 'b', 'abc'.charAt(2) == 'c', 'é'[0] == 'é']").equals("[true, true, true]");
+	code("var r = [] for i in [0..1] { r += 'hello'.left(2) r += 'hello'.right(3) } r").equals("['he', 'llo', 'he', 'llo']");
+	code("['a'.left(0), 'a']").equals("['', 'a']");
+
+	section("String append");
+	code("var s = '' for i in [0..9] { s = s + i } s").equals("'0123456789'");
+	code("var s = 'a' for i in [0..2] { s = s + '-' + i + true } s").equals("'a-0true-1true-2true'");
+	code("var s = 'ab' s = s + s + 'c' s").equals("'ababc'");
+	code("var s = 'x' let t = s s = s + 'y' [s, t]").equals("['xy', 'x']");
+	code("var s = 'x' var a = [s] s = s + 'y' [s, a]").equals("['xy', ['x']]");
+	code("var s = '' var i = 0 while (i < 1000) { s = s + 'ab' i++ } s.size()").equals("2000");
+	code("'ab' * 3").equals("'ababab'");
 }
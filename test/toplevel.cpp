@@ -4,6 +4,8 @@
 #include "../src/vm/value/LSArray.hpp"
 #include "../src/vm/value/LSSet.hpp"
 #include "../src/type/Type.hpp"
+#include "../src/environment/CompiledProgram.hpp"
+#include "../src/analyzer/Program.hpp"
 
 void Test::test_toplevel() {
 	auto& env = getEnv();
@@ -47,4 +49,50 @@ void Test::test_toplevel() {
 	test("Size of context", ctx.vars.size(), 3ul);
 	test("Type of a", ctx.vars.at("a").type, env.any);
 	test("Value of a", *static_cast<ls::LSArray<double>*>(ctx.vars.at("a").value.ls_value), ls::LSArray<double>({ 3.14, 2.71 }));
+
+	section("Compile once, execute many");
+	{
+		auto compiled = env.compile("[1, 2, 3].map(x -> x * 10)");
+		for (int i = 0; i < 3; ++i) {
+			auto result = env.execute(*compiled);
+			test("Run " + std::to_string(i + 1), result.value, std::string("[10, 20, 30]"));
+			test("Run " + std::to_string(i + 1) + " objects", result.objects_created, result.objects_deleted);
+		}
+	}
+	{
+		ls::Context ctx1 { env };
+		ctx1.add_variable((char*) "x", 5, env.integer);
+		auto compiled = env.compile("x * 2", "snippet", &ctx1);
+		ls::Context ctx2 { env };
+		ctx2.add_variable((char*) "x", 21, env.integer);
+		test("Context 1", env.execute(*compiled, &ctx1).value, std::string("10"));
+		test("Context 2", env.execute(*compiled, &ctx2).value, std::string("42"));
+		ls::Context ctx3 { env };
+		ctx3.add_variable((char*) "x", 1.5, env.real);
+		test("Context with another type", env.execute(*compiled, &ctx3).exception.type, ls::vm::Exception::WRONG_ARGUMENT_TYPE);
+	}
+
+	section("Parallel environments");
+	{
+		const int threads = 4;
+		std::vector<std::string> values(threads);
+		std::vector<int> leaks(threads);
+		std::vector<std::thread> workers;
+		for (int t = 0; t < threads; ++t) {
+			workers.emplace_back([&, t]() {
+				ls::Environment thread_env;
+				ls::Program program { thread_env, "var s = 0 for i in [1..1000] { s += i } [s, null, true, 'a' + " + std::to_string(t) + "]", "snippet" };
+				thread_env.analyze(program);
+				thread_env.compile(program);
+				thread_env.execute(program);
+				values[t] = program.result.value;
+				leaks[t] = program.result.objects_created - program.result.objects_deleted;
+			});
+		}
+		for (auto& worker : workers) worker.join();
+		for (int t = 0; t < threads; ++t) {
+			test("Thread " + std::to_string(t), values[t], "[500500, null, true, 'a" + std::to_string(t) + "']");
+			test("Thread " + std::to_string(t) + " objects", leaks[t], 0);
+		}
+	}
 }